@@ -448,6 +448,8 @@ void AutoType::performGlobalAutoType(const QList<QSharedPointer<Database>>& dbLi
 
     QList<AutoTypeMatch> matchList;
     bool hideExpired = config()->get(Config::AutoTypeHideExpiredEntry).toBool();
+    bool matchTitle = config()->get(Config::AutoTypeEntryTitleMatch).toBool();
+    bool matchUrl = config()->get(Config::AutoTypeEntryURLMatch).toBool();
 
     for (const auto& db : dbList) {
         const QList<Entry*> dbEntries = db->rootGroup()->entriesRecursive();
@@ -460,7 +462,7 @@ void AutoType::performGlobalAutoType(const QList<QSharedPointer<Database>>& dbLi
             if (hideExpired && entry->isExpired()) {
                 continue;
             }
-            auto sequences = entry->autoTypeSequences(m_windowTitleForGlobal).toSet();
+            auto sequences = entry->autoTypeSequences(m_windowTitleForGlobal, matchTitle, matchUrl).toSet();
             for (const auto& sequence : sequences) {
                 matchList << AutoTypeMatch(entry, sequence);
             }
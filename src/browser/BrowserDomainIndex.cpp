@@ -0,0 +1,173 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrowserDomainIndex.h"
+
+#include "core/Database.h"
+#include "core/Global.h"
+#include "core/Group.h"
+#include "core/UrlTools.h"
+
+#include <QUrl>
+
+BrowserDomainIndex::BrowserDomainIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+{
+    connect(db, &Database::entryAdded, this, &BrowserDomainIndex::addEntry);
+    connect(db, &Database::entryRemoved, this, &BrowserDomainIndex::removeEntry);
+    // Whole subtrees can be attached or detached without individual entry signals
+    connect(db, &Database::groupAdded, this, [this] { m_dirty = true; });
+    connect(db, &Database::groupRemoved, this, [this] { m_dirty = true; });
+}
+
+/**
+ * Get the index of a database, it is created on first use and lives as long as the database.
+ */
+BrowserDomainIndex* BrowserDomainIndex::forDatabase(Database* db)
+{
+    Q_ASSERT(db);
+    auto index = db->findChild<BrowserDomainIndex*>(QString(), Qt::FindDirectChildrenOnly);
+    if (!index) {
+        index = new BrowserDomainIndex(db);
+    }
+    return index;
+}
+
+/**
+ * Entries that may match the given site URL. Special URLs (file://, keepassxc://)
+ * are not covered by the index and must be handled by a full search.
+ */
+QSet<Entry*> BrowserDomainIndex::candidates(const QString& siteUrl)
+{
+    if (m_dirty || m_rootGroup != m_db->rootGroup()) {
+        rebuild();
+    }
+
+    auto result = m_unresolvedEntries;
+    const auto domain = baseDomain(QUrl(siteUrl).host());
+    for (auto it = m_entriesByDomain.constFind(domain); it != m_entriesByDomain.cend() && it.key() == domain; ++it) {
+        result.insert(it.value());
+    }
+    return result;
+}
+
+void BrowserDomainIndex::rebuild()
+{
+    for (auto it = m_domainsByEntry.cbegin(); it != m_domainsByEntry.cend(); ++it) {
+        disconnect(it.key(), nullptr, this, nullptr);
+    }
+    for (auto entry : asConst(m_unresolvedEntries)) {
+        disconnect(entry, nullptr, this, nullptr);
+    }
+    m_entriesByDomain.clear();
+    m_domainsByEntry.clear();
+    m_unresolvedEntries.clear();
+
+    m_rootGroup = m_db->rootGroup();
+    m_dirty = false;
+    if (!m_rootGroup) {
+        return;
+    }
+
+    for (auto entry : m_rootGroup->entriesRecursive()) {
+        addEntry(entry);
+    }
+}
+
+void BrowserDomainIndex::addEntry(Entry* entry)
+{
+    if (m_dirty) {
+        return;
+    }
+
+    if (!m_domainsByEntry.contains(entry) && !m_unresolvedEntries.contains(entry)) {
+        connect(entry, &Entry::modified, this, [this, entry] { updateEntry(entry); });
+    }
+    updateEntry(entry);
+}
+
+void BrowserDomainIndex::removeEntry(Entry* entry)
+{
+    if (m_dirty) {
+        return;
+    }
+
+    disconnect(entry, nullptr, this, nullptr);
+    for (const auto& domain : m_domainsByEntry.take(entry)) {
+        m_entriesByDomain.remove(domain, entry);
+    }
+    m_unresolvedEntries.remove(entry);
+}
+
+void BrowserDomainIndex::updateEntry(Entry* entry)
+{
+    for (const auto& domain : m_domainsByEntry.take(entry)) {
+        m_entriesByDomain.remove(domain, entry);
+    }
+    m_unresolvedEntries.remove(entry);
+
+    // Same URL selection as Entry::getAllUrls() without resolving placeholders
+    QStringList urls{entry->url()};
+    const auto attributes = entry->attributes();
+    for (const auto& key : attributes->keys()) {
+        if (key.startsWith(EntryAttributes::AdditionalUrlAttribute)
+            || key == QString("%1_RELYING_PARTY").arg(EntryAttributes::PasskeyAttribute)) {
+            urls << attributes->value(key);
+        }
+    }
+
+    QStringList domains;
+    for (const auto& url : asConst(urls)) {
+        if (url.isEmpty()) {
+            continue;
+        }
+        if (url.contains('{')) {
+            m_unresolvedEntries.insert(entry);
+            break;
+        }
+
+        // Host extraction as done by BrowserService::handleURL()
+        const auto host = url.contains("://") ? QUrl(url).host() : QUrl::fromUserInput(url).host();
+        if (host.isEmpty()) {
+            continue;
+        }
+        domains << baseDomain(host);
+        if (host.startsWith("www.")) {
+            domains << baseDomain(QString(host).remove("www."));
+        }
+    }
+
+    if (m_unresolvedEntries.contains(entry)) {
+        return;
+    }
+
+    domains.removeDuplicates();
+    for (const auto& domain : asConst(domains)) {
+        m_entriesByDomain.insert(domain, entry);
+    }
+    m_domainsByEntry.insert(entry, domains);
+}
+
+QString BrowserDomainIndex::baseDomain(const QString& host)
+{
+    auto it = m_baseDomainCache.constFind(host);
+    if (it != m_baseDomainCache.cend()) {
+        return it.value();
+    }
+    return m_baseDomainCache.insert(host, urlTools()->getBaseDomainFromUrl(host)).value();
+}
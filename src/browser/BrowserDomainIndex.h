@@ -0,0 +1,66 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_BROWSERDOMAININDEX_H
+#define KEEPASSXC_BROWSERDOMAININDEX_H
+
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+#include <QStringList>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Reverse index from the base domain of entry URLs to entries of a database.
+ *
+ * The index only narrows down the entries that can possibly match a site URL,
+ * the actual matching is still done by BrowserService::handleURL(). Entries with
+ * placeholders or references in their URLs are always returned as candidates
+ * because their resolved URLs depend on other entries.
+ */
+class BrowserDomainIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    static BrowserDomainIndex* forDatabase(Database* db);
+
+    QSet<Entry*> candidates(const QString& siteUrl);
+    void rebuild();
+
+private:
+    explicit BrowserDomainIndex(Database* db);
+
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+    void updateEntry(Entry* entry);
+    QString baseDomain(const QString& host);
+
+    Database* m_db;
+    QPointer<Group> m_rootGroup;
+    bool m_dirty = true;
+
+    QMultiHash<QString, Entry*> m_entriesByDomain;
+    QHash<Entry*, QStringList> m_domainsByEntry;
+    QSet<Entry*> m_unresolvedEntries;
+    QHash<QString, QString> m_baseDomainCache;
+};
+
+#endif // KEEPASSXC_BROWSERDOMAININDEX_H
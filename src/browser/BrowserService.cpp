@@ -19,6 +19,7 @@
 
 #include "BrowserService.h"
 #include "BrowserAction.h"
+#include "BrowserDomainIndex.h"
 #include "BrowserEntryConfig.h"
 #include "BrowserEntrySaveDialog.h"
 #include "BrowserHost.h"
@@ -988,22 +989,44 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
         return entries;
     }
 
-    for (const auto& group : rootGroup->groupsRecursive(true)) {
+    // Only entries with a matching base domain need to be checked, except for special URLs
+    const bool useIndex = !passkey && !siteUrl.startsWith("file://") && !siteUrl.startsWith("keepassxc://");
+    QSet<Entry*> candidates;
+    QSet<const Group*> candidateGroups;
+    if (useIndex) {
+        candidates = BrowserDomainIndex::forDatabase(db.data())->candidates(siteUrl);
+        if (candidates.isEmpty()) {
+            return entries;
+        }
+        for (const auto* entry : asConst(candidates)) {
+            candidateGroups.insert(entry->group());
+        }
+    }
+
+    rootGroup->forEachGroupRecursive([&](const Group* group) {
+        if (useIndex && !candidateGroups.contains(group)) {
+            return;
+        }
+
         if (group->isRecycled()
             || group->resolveCustomDataTriState(BrowserService::OPTION_HIDE_ENTRY) == Group::Enable) {
-            continue;
+            return;
         }
 
         // If a key restriction is specified and not contained in the keys list then skip this group.
         auto restrictKey = group->resolveCustomDataString(BrowserService::OPTION_RESTRICT_KEY);
         if (!restrictKey.isEmpty() && !keys.contains(restrictKey)) {
-            continue;
+            return;
         }
 
         const auto omitWwwSubdomain =
             group->resolveCustomDataTriState(BrowserService::OPTION_OMIT_WWW) == Group::Enable;
 
         for (auto* entry : group->entries()) {
+            if (useIndex && !candidates.contains(entry)) {
+                continue;
+            }
+
             if (entry->isRecycled()
                 || (entry->customData()->contains(BrowserService::OPTION_HIDE_ENTRY)
                     && entry->customData()->value(BrowserService::OPTION_HIDE_ENTRY) == TRUE_STR)) {
@@ -1026,7 +1049,7 @@ QList<Entry*> BrowserService::searchEntries(const QSharedPointer<Database>& db,
                 entries.append(entry);
             }
         }
-    }
+    });
 
     return entries;
 }
@@ -1477,7 +1500,7 @@ bool BrowserService::handleURL(const QString& entryUrl,
     }
 
     // Check for illegal characters
-    QRegularExpression re("[<>\\^`{|}]");
+    static const QRegularExpression re("[<>\\^`{|}]");
     if (re.match(entryUrl).hasMatch()) {
         return false;
     }
@@ -1632,6 +1655,11 @@ void BrowserService::databaseUnlocked(DatabaseWidget* dbWidget)
             hideWindow();
         }
 
+        // Prepare the URL index so the first request doesn't have to wait for it
+        if (browserSettings()->isEnabled() && dbWidget->database()) {
+            BrowserDomainIndex::forDatabase(dbWidget->database().data())->rebuild();
+        }
+
         QJsonObject msg;
         msg["action"] = QString("database-unlocked");
         m_browserHost->broadcastClientMessage(msg);
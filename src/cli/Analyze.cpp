@@ -20,6 +20,7 @@
 #include "Utils.h"
 #include "core/Group.h"
 #include "core/HibpOffline.h"
+#include "core/PasswordHealth.h"
 
 #include <QCommandLineParser>
 #include <QFile>
@@ -27,24 +28,48 @@
 const QCommandLineOption Analyze::HIBPDatabaseOption = QCommandLineOption(
     {"H", "hibp"},
     QObject::tr("Check if any passwords have been publicly leaked. FILENAME must be the path of a file listing "
-                "SHA-1 hashes of leaked passwords in HIBP format, as available from "
-                "https://haveibeenpwned.com/Passwords."),
+                "SHA-1 hashes of leaked passwords in HIBP format, ordered by hash, as available from "
+                "https://haveibeenpwned.com/Passwords, or an index created from such a file with hibp-index."),
     QObject::tr("FILENAME"));
 
-const QCommandLineOption Analyze::OkonOption =
-    QCommandLineOption("okon",
-                       QObject::tr("Path to okon-cli to search a formatted HIBP file"),
-                       QObject::tr("okon-cli"));
+const QCommandLineOption Analyze::WeakOption =
+    QCommandLineOption({"w", "weak"},
+                       QObject::tr("Report passwords that are weak, re-used or about to expire. "
+                                   "Only checks for leaked passwords if --hibp is given as well."));
+
+namespace
+{
+    QString entryPath(const Entry* entry)
+    {
+        QString path = entry->title();
+        for (auto g = entry->group(); g && g != g->database()->rootGroup(); g = g->parentGroup()) {
+            path.prepend("/").prepend(g->name());
+        }
+        return path;
+    }
+} // namespace
 
 Analyze::Analyze()
 {
     name = QString("analyze");
     description = QObject::tr("Analyze passwords for weaknesses and problems.");
     options.append(Analyze::HIBPDatabaseOption);
-    options.append(Analyze::OkonOption);
+    options.append(Analyze::WeakOption);
 }
 
 int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
+{
+    if (parser->isSet(Analyze::WeakOption)) {
+        reportWeak(database);
+        if (!parser->isSet(Analyze::HIBPDatabaseOption)) {
+            return EXIT_SUCCESS;
+        }
+    }
+
+    return reportHibp(database, parser->value(Analyze::HIBPDatabaseOption));
+}
+
+int Analyze::reportHibp(QSharedPointer<Database> database, const QString& hibpDatabase)
 {
     auto& out = Utils::STDOUT;
     auto& err = Utils::STDERR;
@@ -52,44 +77,28 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
     QList<QPair<const Entry*, int>> findings;
     QString error;
 
-    auto hibpDatabase = parser->value(Analyze::HIBPDatabaseOption);
     if (!QFile::exists(hibpDatabase) || hibpDatabase.isEmpty()) {
         err << QObject::tr("Cannot find HIBP file: %1").arg(hibpDatabase);
         return EXIT_FAILURE;
     }
 
-    auto okon = parser->value(Analyze::OkonOption);
-    if (!okon.isEmpty()) {
-        out << QObject::tr("Evaluating database entries using okon…") << endl;
-
-        if (!HibpOffline::okonReport(database, okon, hibpDatabase, findings, &error)) {
-            err << error << endl;
-            return EXIT_FAILURE;
-        }
-    } else {
-        QFile hibpFile(hibpDatabase);
-        if (!hibpFile.open(QFile::ReadOnly)) {
-            err << QObject::tr("Failed to open HIBP file %1: %2").arg(hibpDatabase).arg(hibpFile.errorString()) << endl;
-            return EXIT_FAILURE;
-        }
+    QFile hibpFile(hibpDatabase);
+    if (!hibpFile.open(QFile::ReadOnly)) {
+        err << QObject::tr("Failed to open HIBP file %1: %2").arg(hibpDatabase).arg(hibpFile.errorString()) << endl;
+        return EXIT_FAILURE;
+    }
 
-        out << QObject::tr("Evaluating database entries against HIBP file, this will take a while…") << endl;
+    out << QObject::tr("Evaluating database entries against HIBP file…") << endl;
 
-        if (!HibpOffline::report(database, hibpFile, findings, &error)) {
-            err << error << endl;
-            return EXIT_FAILURE;
-        }
+    if (!HibpOffline::report(database, hibpFile, findings, &error)) {
+        err << error << endl;
+        return EXIT_FAILURE;
     }
 
     for (const auto& finding : findings) {
-        const auto entry = finding.first;
+        const auto path = entryPath(finding.first);
         auto count = finding.second;
 
-        QString path = entry->title();
-        for (auto g = entry->group(); g && g != g->database()->rootGroup(); g = g->parentGroup()) {
-            path.prepend("/").prepend(g->name());
-        }
-
         if (count > 0) {
             out << QObject::tr("Password for '%1' has been leaked %2 time(s)!", "", count).arg(path).arg(count) << endl;
         } else {
@@ -99,3 +108,32 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
 
     return EXIT_SUCCESS;
 }
+
+void Analyze::reportWeak(QSharedPointer<Database> database)
+{
+    auto& out = Utils::STDOUT;
+
+    QList<Entry*> entries;
+    for (auto* entry : database->rootGroup()->entriesRecursive()) {
+        if (!entry->isRecycled() && !entry->password().isEmpty() && !entry->excludeFromReports()) {
+            entries << entry;
+        }
+    }
+
+    out << QObject::tr("Evaluating password health of database entries…") << endl;
+
+    PasswordHealthEngine engine;
+    const auto results = engine.evaluate(database, entries);
+    for (int i = 0; i < entries.size(); ++i) {
+        const auto& health = results[i];
+        if (health->quality() >= PasswordHealth::Quality::Good) {
+            continue;
+        }
+
+        out << QObject::tr("Password for '%1' has a score of %2: %3")
+                   .arg(entryPath(entries[i]))
+                   .arg(health->score())
+                   .arg(health->scoreReason().replace('\n', "; "))
+            << endl;
+    }
+}
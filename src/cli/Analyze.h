@@ -27,7 +27,11 @@ public:
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
 
     static const QCommandLineOption HIBPDatabaseOption;
-    static const QCommandLineOption OkonOption;
+    static const QCommandLineOption WeakOption;
+
+private:
+    int reportHibp(QSharedPointer<Database> database, const QString& hibpDatabase);
+    void reportWeak(QSharedPointer<Database> database);
 };
 
 #endif // KEEPASSXC_HIBP_H
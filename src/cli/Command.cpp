@@ -33,6 +33,7 @@
 #include "Export.h"
 #include "Generate.h"
 #include "Help.h"
+#include "HibpIndex.h"
 #include "Import.h"
 #include "List.h"
 #include "Merge.h"
@@ -41,6 +42,7 @@
 #include "Remove.h"
 #include "RemoveGroup.h"
 #include "Search.h"
+#include "Serve.h"
 #include "Show.h"
 #include "Utils.h"
 
@@ -179,6 +181,7 @@ namespace Commands
         s_commands.insert(QStringLiteral("estimate"), QSharedPointer<Command>(new Estimate()));
         s_commands.insert(QStringLiteral("generate"), QSharedPointer<Command>(new Generate()));
         s_commands.insert(QStringLiteral("help"), QSharedPointer<Command>(new Help()));
+        s_commands.insert(QStringLiteral("hibp-index"), QSharedPointer<Command>(new HibpIndex()));
         s_commands.insert(QStringLiteral("ls"), QSharedPointer<Command>(new List()));
         s_commands.insert(QStringLiteral("merge"), QSharedPointer<Command>(new Merge()));
         s_commands.insert(QStringLiteral("mkdir"), QSharedPointer<Command>(new AddGroup()));
@@ -195,6 +198,7 @@ namespace Commands
         } else {
             s_commands.insert(QStringLiteral("export"), QSharedPointer<Command>(new Export()));
             s_commands.insert(QStringLiteral("import"), QSharedPointer<Command>(new Import()));
+            s_commands.insert(QStringLiteral("serve"), QSharedPointer<Command>(new Serve()));
         }
     }
 
@@ -0,0 +1,245 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Serve.h"
+
+#include "Add.h"
+#include "Edit.h"
+#include "Search.h"
+#include "Show.h"
+#include "Utils.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QEventLoop>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTextCodec>
+#include <QTimer>
+
+namespace
+{
+    constexpr int DEFAULT_IDLE_TIMEOUT = 600;
+
+    QJsonObject errorResponse(const QJsonValue& id, const QString& message)
+    {
+        QJsonObject response;
+        response["id"] = id;
+        response["exitCode"] = EXIT_FAILURE;
+        response["stdout"] = QString();
+        response["stderr"] = message + "\n";
+        return response;
+    }
+
+    // Returns true if another process is still accepting connections on the socket
+    bool isServing(const QString& socketPath)
+    {
+        QLocalSocket socket;
+        socket.connectToServer(socketPath);
+        return socket.waitForConnected(100);
+    }
+} // namespace
+
+const QCommandLineOption Serve::IdleTimeoutOption =
+    QCommandLineOption(QStringList() << "idle-timeout",
+                       QObject::tr("Lock the database and stop serving after the given number of seconds without "
+                                   "requests, 0 to never lock. Defaults to %1.")
+                           .arg(DEFAULT_IDLE_TIMEOUT),
+                       QObject::tr("seconds"));
+
+Serve::Serve()
+{
+    name = QString("serve");
+    description = QObject::tr("Unlock a database once and answer requests on a local socket.");
+    options.append(Serve::IdleTimeoutOption);
+    positionalArguments.append({QString("socket"), QObject::tr("Path of the socket to listen on."), QString("")});
+
+    // The commands a client may run, "totp" is served by "show --totp"
+    m_commands.insert(QStringLiteral("add"), QSharedPointer<Command>(new Add()));
+    m_commands.insert(QStringLiteral("edit"), QSharedPointer<Command>(new Edit()));
+    m_commands.insert(QStringLiteral("search"), QSharedPointer<Command>(new Search()));
+    m_commands.insert(QStringLiteral("show"), QSharedPointer<Command>(new Show()));
+}
+
+int Serve::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
+{
+    auto& out = parser->isSet(Command::QuietOption) ? Utils::DEVNULL : Utils::STDOUT;
+    auto& err = Utils::STDERR;
+
+    const QString& socketPath = parser->positionalArguments().at(1);
+
+    int idleTimeout = DEFAULT_IDLE_TIMEOUT;
+    if (parser->isSet(Serve::IdleTimeoutOption)) {
+        bool ok;
+        idleTimeout = parser->value(Serve::IdleTimeoutOption).toInt(&ok);
+        if (!ok || idleTimeout < 0) {
+            err << QObject::tr("Invalid idle timeout %1.").arg(parser->value(Serve::IdleTimeoutOption)) << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    QLocalServer server;
+    server.setSocketOptions(QLocalServer::UserAccessOption);
+    if (!server.listen(socketPath)) {
+        // Clean up a socket left behind by a server that did not shut down properly
+        if (server.serverError() != QAbstractSocket::AddressInUseError || isServing(socketPath)
+            || !QLocalServer::removeServer(socketPath) || !server.listen(socketPath)) {
+            err << QObject::tr("Failed to listen on %1: %2").arg(socketPath, server.errorString()) << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Entries added or edited by clients are saved right away, derive the next key in the meantime
+    database->setPrecomputeNextKey(true);
+
+    QEventLoop loop;
+    QTimer idleTimer;
+    idleTimer.setSingleShot(true);
+    idleTimer.setInterval(idleTimeout * 1000);
+    QObject::connect(&idleTimer, &QTimer::timeout, &loop, &QEventLoop::quit);
+
+    QObject::connect(&server, &QLocalServer::newConnection, [&] {
+        while (QLocalSocket* socket = server.nextPendingConnection()) {
+            QObject::connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+            QObject::connect(socket, &QLocalSocket::readyRead, socket, [&, socket] {
+                while (socket->canReadLine()) {
+                    bool lock = false;
+                    auto response = handleRequest(database, socket->readLine(), &lock);
+                    socket->write(QJsonDocument(response).toJson(QJsonDocument::Compact).append('\n'));
+                    if (idleTimeout > 0) {
+                        idleTimer.start();
+                    }
+                    if (lock) {
+                        socket->waitForBytesWritten(1000);
+                        loop.quit();
+                        return;
+                    }
+                }
+            });
+        }
+    });
+
+    out << QObject::tr("Serving %1 on %2.").arg(database->filePath(), socketPath) << endl;
+
+    if (idleTimeout > 0) {
+        idleTimer.start();
+    }
+    loop.exec();
+
+    server.close();
+    database->releaseData();
+    out << QObject::tr("Database locked.") << endl;
+
+    return EXIT_SUCCESS;
+}
+
+QJsonObject Serve::handleRequest(QSharedPointer<Database> database, const QByteArray& request, bool* lock)
+{
+    QJsonParseError parseError;
+    const auto document = QJsonDocument::fromJson(request, &parseError);
+    if (parseError.error != QJsonParseError::NoError || !document.isObject()) {
+        return errorResponse(QJsonValue(), QObject::tr("Invalid request: %1").arg(parseError.errorString()));
+    }
+
+    const auto object = document.object();
+    const auto id = object.value("id");
+    const auto commandName = object.value("command").toString();
+
+    QStringList arguments;
+    for (const auto& argument : object.value("arguments").toArray()) {
+        arguments << argument.toString();
+    }
+
+    if (commandName == "lock") {
+        *lock = true;
+        QJsonObject response;
+        response["id"] = id;
+        response["exitCode"] = EXIT_SUCCESS;
+        response["stdout"] = QString();
+        response["stderr"] = QString();
+        return response;
+    }
+
+    QSharedPointer<Command> command;
+    if (commandName == "totp") {
+        command = m_commands.value("show");
+        arguments.prepend(QStringLiteral("--totp"));
+    } else {
+        command = m_commands.value(commandName);
+    }
+
+    if (!command) {
+        return errorResponse(id, QObject::tr("Invalid command %1.").arg(commandName));
+    }
+
+    arguments.prepend(command->name);
+
+    QString output;
+    QString error;
+    int exitCode = runCommand(command.data(), database, arguments, object.value("stdin").toString(), &output, &error);
+
+    QJsonObject response;
+    response["id"] = id;
+    response["exitCode"] = exitCode;
+    response["stdout"] = output;
+    response["stderr"] = error;
+    return response;
+}
+
+/**
+ * Run a command against the served database, capturing its output.
+ * The database argument is filled in by DatabaseCommand::execute.
+ */
+int Serve::runCommand(Command* command,
+                      QSharedPointer<Database> database,
+                      const QStringList& arguments,
+                      const QString& input,
+                      QString* output,
+                      QString* error)
+{
+    auto* stdoutDevice = Utils::STDOUT.device();
+    auto* stderrDevice = Utils::STDERR.device();
+    auto* stdinDevice = Utils::STDIN.device();
+
+    QBuffer outBuffer;
+    QBuffer errBuffer;
+    QBuffer inBuffer;
+    outBuffer.open(QIODevice::WriteOnly);
+    errBuffer.open(QIODevice::WriteOnly);
+    inBuffer.setData(Utils::STDIN.codec()->fromUnicode(input));
+    inBuffer.open(QIODevice::ReadOnly);
+
+    Utils::STDOUT.setDevice(&outBuffer);
+    Utils::STDERR.setDevice(&errBuffer);
+    Utils::STDIN.setDevice(&inBuffer);
+
+    command->currentDatabase = database;
+    int exitCode = command->execute(arguments);
+    command->currentDatabase.reset();
+
+    Utils::STDOUT.flush();
+    Utils::STDERR.flush();
+    Utils::STDOUT.setDevice(stdoutDevice);
+    Utils::STDERR.setDevice(stderrDevice);
+    Utils::STDIN.setDevice(stdinDevice);
+
+    *output = Utils::STDOUT.codec()->toUnicode(outBuffer.data());
+    *error = Utils::STDERR.codec()->toUnicode(errBuffer.data());
+    return exitCode;
+}
@@ -0,0 +1,46 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_SERVE_H
+#define KEEPASSXC_SERVE_H
+
+#include "DatabaseCommand.h"
+
+#include <QJsonObject>
+
+class Serve : public DatabaseCommand
+{
+public:
+    Serve();
+
+    int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
+
+    static const QCommandLineOption IdleTimeoutOption;
+
+private:
+    QJsonObject handleRequest(QSharedPointer<Database> db, const QByteArray& request, bool* lock);
+    int runCommand(Command* command,
+                   QSharedPointer<Database> db,
+                   const QStringList& arguments,
+                   const QString& input,
+                   QString* output,
+                   QString* error);
+
+    QMap<QString, QSharedPointer<Command>> m_commands;
+};
+
+#endif // KEEPASSXC_SERVE_H
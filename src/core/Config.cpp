@@ -18,6 +18,7 @@
 
 #include "Config.h"
 #include "Global.h"
+#include "core/FileWatcher.h"
 
 #include <QCoreApplication>
 #include <QDir>
@@ -80,6 +81,9 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
     {Config::GlobalAutoTypeModifiers,{QS("GlobalAutoTypeModifiers"), Roaming, 0}},
     {Config::GlobalAutoTypeRetypeTime,{QS("GlobalAutoTypeRetypeTime"), Roaming, 15}},
     {Config::FaviconDownloadTimeout,{QS("FaviconDownloadTimeout"), Roaming, 10}},
+    {Config::HibpRangeUrl,{QS("HibpRangeUrl"), Roaming, QS("https://api.pwnedpasswords.com/range/")}},
+    {Config::HibpMaxConcurrentRequests,{QS("HibpMaxConcurrentRequests"), Roaming, 6}},
+    {Config::HibpCacheTtl,{QS("HibpCacheTtl"), Local, 86400}},
     {Config::UpdateCheckMessageShown,{QS("UpdateCheckMessageShown"), Roaming, false}},
     {Config::DefaultDatabaseFileName,{QS("DefaultDatabaseFileName"), Roaming, {}}},
 
@@ -226,14 +230,69 @@ static const QHash<Config::ConfigKey, ConfigDirective> configStrings = {
 
 QPointer<Config> Config::m_instance(nullptr);
 
+namespace
+{
+    /**
+     * Ini files store every value as a string, convert boolean and integer
+     * settings back to the type of their default so reading them stays cheap.
+     */
+    QVariant normalizedValue(const QVariant& value, const QVariant& defaultValue)
+    {
+        const auto type = defaultValue.userType();
+        if ((type == QMetaType::Bool || type == QMetaType::Int) && value.isValid() && value.userType() != type) {
+            auto converted = value;
+            if (converted.convert(type)) {
+                return converted;
+            }
+        }
+        return value;
+    }
+} // namespace
+
+/**
+ * Get the value of a setting.
+ *
+ * Values are served from an in-memory copy of the settings files that is kept
+ * up to date by set(), remove() and changes made to the files by other processes.
+ */
 QVariant Config::get(ConfigKey key)
 {
-    auto cfg = configStrings[key];
-    auto defaultValue = configStrings[key].defaultValue;
+    QReadLocker locker(&m_valuesLock);
+    return m_values.value(key);
+}
+
+QVariant Config::readValue(ConfigKey key) const
+{
+    const auto& cfg = configStrings[key];
     if (m_localSettings && cfg.type == Local) {
-        return m_localSettings->value(cfg.name, defaultValue);
+        return normalizedValue(m_localSettings->value(cfg.name, cfg.defaultValue), cfg.defaultValue);
+    }
+    return normalizedValue(m_settings->value(cfg.name, cfg.defaultValue), cfg.defaultValue);
+}
+
+/**
+ * Refresh the in-memory copy of all settings.
+ *
+ * @return keys whose value differs from the previous copy
+ */
+QList<Config::ConfigKey> Config::loadValues()
+{
+    QVector<QVariant> values(Deleted);
+    for (int i = 0; i < Deleted; ++i) {
+        values[i] = readValue(static_cast<ConfigKey>(i));
+    }
+
+    QList<ConfigKey> changedKeys;
+    QWriteLocker locker(&m_valuesLock);
+    if (m_values.size() == values.size()) {
+        for (int i = 0; i < Deleted; ++i) {
+            if (m_values.at(i) != values.at(i)) {
+                changedKeys << static_cast<ConfigKey>(i);
+            }
+        }
     }
-    return m_settings->value(cfg.name, defaultValue);
+    m_values = values;
+    return changedKeys;
 }
 
 QVariant Config::getDefault(Config::ConfigKey key)
@@ -257,25 +316,35 @@ void Config::set(ConfigKey key, const QVariant& value)
         return;
     }
 
-    auto cfg = configStrings[key];
+    const auto& cfg = configStrings[key];
     if (cfg.type == Local && m_localSettings) {
         m_localSettings->setValue(cfg.name, value);
     } else {
         m_settings->setValue(cfg.name, value);
     }
 
+    {
+        QWriteLocker locker(&m_valuesLock);
+        m_values[key] = normalizedValue(value, cfg.defaultValue);
+    }
+
     emit changed(key);
 }
 
 void Config::remove(ConfigKey key)
 {
-    auto cfg = configStrings[key];
+    const auto& cfg = configStrings[key];
     if (cfg.type == Local && m_localSettings) {
         m_localSettings->remove(cfg.name);
     } else {
         m_settings->remove(cfg.name);
     }
 
+    {
+        QWriteLocker locker(&m_valuesLock);
+        m_values[key] = cfg.defaultValue;
+    }
+
     emit changed(key);
 }
 
@@ -300,6 +369,31 @@ void Config::resetToDefaults()
     if (m_localSettings) {
         m_localSettings->clear();
     }
+    loadValues();
+}
+
+/**
+ * Pick up changes made to the settings files by other processes,
+ * notifying about every setting whose value changed.
+ */
+void Config::reload()
+{
+    sync();
+    const auto changedKeys = loadValues();
+    for (const auto key : changedKeys) {
+        emit changed(key);
+    }
+}
+
+void Config::watchFile(const QString& fileName)
+{
+    auto watcher = new FileWatcher(this);
+    connect(watcher, &FileWatcher::fileChanged, this, [this, watcher](const QString& path) {
+        reload();
+        // Saving replaces the file, watch the new one
+        watcher->start(path);
+    });
+    watcher->start(fileName);
 }
 
 /**
@@ -503,7 +597,15 @@ void Config::init(const QString& configFileName, const QString& localConfigFileN
         m_localSettings.reset(new QSettings(localConfigFileName, QSettings::IniFormat));
     }
 
+    loadValues();
     migrate();
+    loadValues();
+
+    watchFile(m_settings->fileName());
+    if (m_localSettings) {
+        watchFile(m_localSettings->fileName());
+    }
+
     connect(qApp, &QCoreApplication::aboutToQuit, this, &Config::sync);
 }
 
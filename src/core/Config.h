@@ -20,6 +20,7 @@
 #define KEEPASSX_CONFIG_H
 
 #include <QPointer>
+#include <QReadWriteLock>
 #include <QVariant>
 #include <QVector>
 
@@ -63,6 +64,9 @@ public:
         GlobalAutoTypeModifiers,
         GlobalAutoTypeRetypeTime,
         FaviconDownloadTimeout,
+        HibpRangeUrl,
+        HibpMaxConcurrentRequests,
+        HibpCacheTtl,
         UpdateCheckMessageShown,
         DefaultDatabaseFileName,
 
@@ -234,6 +238,10 @@ private:
     explicit Config(QObject* parent);
     void init(const QString& configFileName, const QString& localConfigFileName);
     void migrate();
+    void watchFile(const QString& fileName);
+    void reload();
+    QVariant readValue(ConfigKey key) const;
+    QList<ConfigKey> loadValues();
     static QPair<QString, QString> defaultConfigFiles();
 
     static QPointer<Config> m_instance;
@@ -241,6 +249,8 @@ private:
     QScopedPointer<QSettings> m_settings;
     QScopedPointer<QSettings> m_localSettings;
     QHash<QString, QVariant> m_defaults;
+    QVector<QVariant> m_values;
+    QReadWriteLock m_valuesLock;
 };
 
 inline Config* config()
@@ -57,11 +57,16 @@ Database::Database()
 
     // other signals
     connect(m_metadata, &Metadata::modified, this, &Database::markAsModified);
+    connect(m_metadata, &Metadata::modified, this, [this] {
+        // Entries move in or out of the recycle bin when it is replaced
+        if (m_indexedRecycleBin != m_metadata->recycleBin()) {
+            rebuildEntryIndexes();
+        }
+    });
     connect(this, &Database::databaseOpened, this, [this]() {
         updateCommonUsernames();
         updateTagList();
     });
-    connect(this, &Database::modified, this, [this] { updateTagList(); });
     connect(this, &Database::databaseSaved, this, [this]() { updateCommonUsernames(); });
     connect(m_fileWatcher, &FileWatcher::fileChanged, this, &Database::databaseFileChanged);
 
@@ -162,6 +167,7 @@ bool Database::open(const QString& filePath, QSharedPointer<const CompositeKey>
     setFilePath(filePath);
     dbFile.close();
 
+    Q_ASSERT(verifyUuidIndex());
     markAsClean();
 
     emit databaseOpened();
@@ -420,6 +426,8 @@ bool Database::writeDatabase(QIODevice* device, QString* error)
         oldTransformedKey.setRawKey(m_data.transformedDatabaseKey->rawKey());
     }
 
+    Q_ASSERT(verifyUuidIndex());
+
     KeePass2Writer writer;
     setEmitModified(false);
     writer.writeDatabase(device, this);
@@ -503,6 +511,7 @@ void Database::releaseData()
     m_uuid = QUuid();
 
     m_data.clear();
+    precomputeNextKey();
     m_metadata->clear();
 
     // Reset and delete the root group
@@ -597,6 +606,13 @@ Group* Database::setRootGroup(Group* group)
 
     auto oldRoot = m_rootGroup;
     m_rootGroup = group;
+
+    // Only the entries of the new root group are indexed
+    m_indexedEntries.clear();
+    m_tagCounts.clear();
+    m_usernameCounts.clear();
+    m_tagCountsChanged = true;
+    m_indexedRecycleBin = m_metadata->recycleBin();
     m_rootGroup->setParent(this);
 
     // Initialize the root group if not done already
@@ -605,6 +621,8 @@ Group* Database::setRootGroup(Group* group)
         m_rootGroup->setName(tr("Passwords", "Root group name"));
     }
 
+    updateTagList();
+
     return oldRoot;
 }
 
@@ -717,43 +735,289 @@ const QStringList& Database::tagList() const
     return m_tagList;
 }
 
-void Database::updateCommonUsernames(int topN)
+namespace
 {
-    m_commonUsernames.clear();
-    m_commonUsernames.append(rootGroup()->usernamesRecursive(topN));
+    bool isInSubtree(const Group* group, const Group* scope)
+    {
+        for (; group; group = group->parentGroup()) {
+            if (group == scope) {
+                return true;
+            }
+        }
+        return false;
+    }
+} // namespace
+
+/**
+ * Find an entry by its UUID using the database index.
+ *
+ * @param uuid UUID of the entry
+ * @param scope only return entries below this group, defaults to the root group
+ * @param recursive if false, only return direct children of scope
+ * @return the entry or nullptr if there is no such entry in scope
+ */
+Entry* Database::findEntryByUuid(const QUuid& uuid, const Group* scope, bool recursive) const
+{
+    if (!scope) {
+        scope = m_rootGroup;
+    }
+
+    for (auto it = m_entryUuidIndex.constFind(uuid); it != m_entryUuidIndex.cend() && it.key() == uuid; ++it) {
+        auto entry = it.value();
+        if (recursive ? isInSubtree(entry->group(), scope) : entry->group() == scope) {
+            return entry;
+        }
+    }
+
+    return nullptr;
 }
 
-void Database::updateTagList()
+/**
+ * Find a group by its UUID using the database index.
+ *
+ * @param uuid UUID of the group
+ * @param scope only return groups below this group (inclusive), defaults to the root group
+ * @return the group or nullptr if there is no such group in scope
+ */
+Group* Database::findGroupByUuid(const QUuid& uuid, const Group* scope) const
+{
+    if (!scope) {
+        scope = m_rootGroup;
+    }
+
+    for (auto it = m_groupUuidIndex.constFind(uuid); it != m_groupUuidIndex.cend() && it.key() == uuid; ++it) {
+        if (isInSubtree(it.value(), scope)) {
+            return it.value();
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * Check the UUID index against the group tree. Every entry and group of the tree
+ * must be indexed and every indexed object must belong to this database.
+ */
+bool Database::verifyUuidIndex() const
 {
-    m_tagList.clear();
     if (!m_rootGroup) {
-        emit tagListUpdated();
+        return true;
+    }
+
+    bool groupsIndexed = m_rootGroup->forEachGroupRecursive([this](Group* group) {
+        return group->uuid().isNull() || m_groupUuidIndex.contains(group->uuid(), group);
+    });
+    bool entriesIndexed = m_rootGroup->forEachEntryRecursive([this](Entry* entry) {
+        return entry->uuid().isNull() || m_entryUuidIndex.contains(entry->uuid(), entry);
+    });
+    if (!groupsIndexed || !entriesIndexed) {
+        return false;
+    }
+
+    for (auto it = m_groupUuidIndex.cbegin(); it != m_groupUuidIndex.cend(); ++it) {
+        if (it.value()->database() != this || it.value()->uuid() != it.key()) {
+            return false;
+        }
+    }
+    for (auto it = m_entryUuidIndex.cbegin(); it != m_entryUuidIndex.cend(); ++it) {
+        if (it.value()->database() != this || it.value()->uuid() != it.key()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Database::addToUuidIndex(Entry* entry)
+{
+    if (!entry->uuid().isNull() && !m_entryUuidIndex.contains(entry->uuid(), entry)) {
+        m_entryUuidIndex.insert(entry->uuid(), entry);
+    }
+}
+
+void Database::addToUuidIndex(Group* group)
+{
+    if (!group->uuid().isNull() && !m_groupUuidIndex.contains(group->uuid(), group)) {
+        m_groupUuidIndex.insert(group->uuid(), group);
+    }
+}
+
+void Database::removeFromUuidIndex(Entry* entry, const QUuid& uuid)
+{
+    m_entryUuidIndex.remove(uuid, entry);
+}
+
+void Database::removeFromUuidIndex(Group* group, const QUuid& uuid)
+{
+    m_groupUuidIndex.remove(uuid, group);
+}
+
+bool Database::IndexedEntry::operator==(const IndexedEntry& other) const
+{
+    return recycled == other.recycled && username == other.username && tags == other.tags;
+}
+
+Database::IndexedEntry Database::indexedEntry(const Entry* entry) const
+{
+    IndexedEntry indexed;
+    indexed.tags = entry->tagList();
+    indexed.recycled = entry->isRecycled();
+    if (!entry->isAttributeReference(EntryAttributes::UserNameKey)) {
+        indexed.username = entry->username();
+    }
+    return indexed;
+}
+
+void Database::addToEntryIndexes(Entry* entry)
+{
+    if (m_indexedEntries.contains(entry)) {
         return;
     }
 
-    // Search groups recursively looking for tags
-    // Use a set to prevent adding duplicates
-    QSet<QString> tagSet;
-    for (auto entry : m_rootGroup->entriesRecursive()) {
-        if (!entry->isRecycled()) {
-            for (auto tag : entry->tagList()) {
-                tagSet.insert(tag);
+    const auto indexed = indexedEntry(entry);
+    if (!indexed.recycled) {
+        for (const auto& tag : indexed.tags) {
+            if (++m_tagCounts[tag] == 1) {
+                m_tagCountsChanged = true;
             }
         }
     }
+    if (!indexed.username.isEmpty()) {
+        ++m_usernameCounts[indexed.username];
+    }
+    m_indexedEntries.insert(entry, indexed);
+}
+
+void Database::removeFromEntryIndexes(Entry* entry)
+{
+    auto it = m_indexedEntries.find(entry);
+    if (it == m_indexedEntries.end()) {
+        return;
+    }
 
-    m_tagList = tagSet.toList();
-    m_tagList.sort();
-    emit tagListUpdated();
+    if (!it->recycled) {
+        for (const auto& tag : asConst(it->tags)) {
+            auto count = m_tagCounts.find(tag);
+            Q_ASSERT(count != m_tagCounts.end());
+            if (count != m_tagCounts.end() && --count.value() <= 0) {
+                m_tagCounts.erase(count);
+                m_tagCountsChanged = true;
+            }
+        }
+    }
+    if (!it->username.isEmpty()) {
+        auto count = m_usernameCounts.find(it->username);
+        Q_ASSERT(count != m_usernameCounts.end());
+        if (count != m_usernameCounts.end() && --count.value() <= 0) {
+            m_usernameCounts.erase(count);
+        }
+    }
+    m_indexedEntries.erase(it);
 }
 
-void Database::removeTag(const QString& tag)
+void Database::updateEntryIndexes(Entry* entry)
 {
-    if (!m_rootGroup) {
+    auto it = m_indexedEntries.constFind(entry);
+    if (it == m_indexedEntries.constEnd() || it.value() == indexedEntry(entry)) {
         return;
     }
 
-    for (auto entry : m_rootGroup->entriesRecursive()) {
+    removeFromEntryIndexes(entry);
+    addToEntryIndexes(entry);
+}
+
+void Database::updateEntryIndexes(const Group* group)
+{
+    group->forEachEntryRecursive([this](Entry* entry) { updateEntryIndexes(entry); });
+}
+
+/**
+ * Connected to Entry::modified of every entry in the database by Group.
+ */
+void Database::onEntryModified()
+{
+    auto entry = qobject_cast<Entry*>(sender());
+    Q_ASSERT(entry);
+    if (!entry) {
+        return;
+    }
+
+    updateEntryIndexes(entry);
+    updateTagList();
+    emit entryModified(entry);
+}
+
+void Database::rebuildEntryIndexes()
+{
+    m_indexedEntries.clear();
+    m_tagCounts.clear();
+    m_usernameCounts.clear();
+    m_tagCountsChanged = true;
+    m_indexedRecycleBin = m_metadata->recycleBin();
+
+    if (m_rootGroup) {
+        m_rootGroup->forEachEntryRecursive([this](Entry* entry) { addToEntryIndexes(entry); });
+    }
+
+    updateTagList();
+}
+
+void Database::updateCommonUsernames(int topN)
+{
+    // Sort username/frequency pairs by frequency and name
+    QList<QPair<QString, int>> sortedUsernames;
+    sortedUsernames.reserve(m_usernameCounts.size());
+    for (auto it = m_usernameCounts.constBegin(); it != m_usernameCounts.constEnd(); ++it) {
+        sortedUsernames.append({it.key(), it.value()});
+    }
+
+    auto comparator = [](const QPair<QString, int>& arg1, const QPair<QString, int>& arg2) {
+        if (arg1.second == arg2.second) {
+            return arg1.first < arg2.first;
+        }
+        return arg1.second > arg2.second;
+    };
+
+    int actualUsernames = topN < 0 ? sortedUsernames.size() : std::min(topN, sortedUsernames.size());
+    std::partial_sort(
+        sortedUsernames.begin(), sortedUsernames.begin() + actualUsernames, sortedUsernames.end(), comparator);
+
+    m_commonUsernames.clear();
+    for (int i = 0; i < actualUsernames; ++i) {
+        m_commonUsernames.append(sortedUsernames[i].first);
+    }
+}
+
+/**
+ * Publish the tags of all entries outside the recycle bin.
+ * tagListUpdated() is only emitted if the set of tags changed.
+ */
+void Database::updateTagList()
+{
+    if (!m_tagCountsChanged) {
+        return;
+    }
+    m_tagCountsChanged = false;
+
+    auto tagList = m_tagCounts.keys();
+    tagList.sort();
+    if (tagList != m_tagList) {
+        m_tagList = tagList;
+        emit tagListUpdated();
+    }
+}
+
+void Database::removeTag(const QString& tag)
+{
+    // Collect first, removing the tag updates the index
+    QList<Entry*> entries;
+    for (auto it = m_indexedEntries.constBegin(); it != m_indexedEntries.constEnd(); ++it) {
+        if (it->tags.contains(tag)) {
+            entries.append(it.key());
+        }
+    }
+
+    for (auto entry : asConst(entries)) {
         entry->removeTag(tag);
     }
 }
@@ -839,11 +1103,19 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
 
     if (!key) {
         m_data.resetKeys();
+        precomputeNextKey();
         return true;
     }
 
+    QByteArray transformedDatabaseKey;
+    bool precomputed = false;
+
     if (updateTransformSalt) {
-        m_data.kdf->randomizeSeed();
+        // Use the seed and transformed key derived in the background, if they are still valid
+        precomputed = transformKey && takeNextKey(key, transformedDatabaseKey);
+        if (!precomputed) {
+            m_data.kdf->randomizeSeed();
+        }
         Q_ASSERT(!m_data.kdf->seed().isEmpty());
     }
 
@@ -852,11 +1124,9 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
         oldTransformedDatabaseKey.setRawKey(m_data.transformedDatabaseKey->rawKey());
     }
 
-    QByteArray transformedDatabaseKey;
-
     if (!transformKey) {
         transformedDatabaseKey = QByteArray(oldTransformedDatabaseKey.rawKey());
-    } else if (!key->transform(*m_data.kdf, transformedDatabaseKey, &m_keyError)) {
+    } else if (!precomputed && !key->transform(*m_data.kdf, transformedDatabaseKey, &m_keyError)) {
         return false;
     }
 
@@ -872,6 +1142,10 @@ bool Database::setKey(const QSharedPointer<const CompositeKey>& key,
         markAsModified();
     }
 
+    if (updateTransformSalt && transformKey) {
+        precomputeNextKey();
+    }
+
     return true;
 }
 
@@ -880,6 +1154,86 @@ QString Database::keyError()
     return m_keyError;
 }
 
+/**
+ * Derive the KDF seed and transformed key for the next save in the background.
+ *
+ * Every save randomizes the KDF seed and transforms the key again, which takes
+ * as long as the KDF is configured to take. When enabled, the next seed and
+ * transformed key are derived on a worker thread after the database was unlocked
+ * and after every save, so a save only has to wait for the KDF if the previous
+ * derivation has not finished yet.
+ *
+ * Keys with challenge-response components are never derived in the background,
+ * since that would require hardware interaction.
+ */
+void Database::setPrecomputeNextKey(bool enabled)
+{
+    {
+        QMutexLocker locker(&m_nextKeyMutex);
+        m_precomputeNextKey = enabled;
+    }
+    precomputeNextKey();
+}
+
+void Database::precomputeNextKey()
+{
+    QMutexLocker locker(&m_nextKeyMutex);
+    m_nextKey = {};
+
+    const auto key = m_data.key;
+    if (!m_precomputeNextKey || !key || !key->challengeResponseKeys().isEmpty()) {
+        return;
+    }
+
+    const auto kdf = m_data.kdf->clone();
+    kdf->randomizeSeed();
+
+    m_nextKey.key = key;
+    m_nextKey.kdf = kdf;
+    m_nextKey.transformedKey = QtConcurrent::run([key, kdf] {
+        QByteArray transformedKey;
+        if (!key->transform(*kdf, transformedKey)) {
+            transformedKey.clear();
+        }
+        return transformedKey;
+    });
+}
+
+/**
+ * Take the precomputed seed and transformed key, waiting for them if necessary.
+ * On success the new seed is set on the KDF of the database.
+ *
+ * @return false if there is none, or it doesn't match the key and KDF parameters
+ */
+bool Database::takeNextKey(const QSharedPointer<const CompositeKey>& key, QByteArray& transformedKey)
+{
+    NextKey next;
+    {
+        QMutexLocker locker(&m_nextKeyMutex);
+        qSwap(next, m_nextKey);
+    }
+
+    if (!next.key || next.key != key || next.kdf->uuid() != m_data.kdf->uuid()) {
+        return false;
+    }
+
+    // All KDF parameters except the seed must still be the same
+    auto kdf = m_data.kdf->clone();
+    kdf->setSeed(next.kdf->seed());
+    if (kdf->writeParameters() != next.kdf->writeParameters()) {
+        return false;
+    }
+
+    const auto result = next.transformedKey.result();
+    if (result.isEmpty()) {
+        return false;
+    }
+
+    m_data.kdf->setSeed(next.kdf->seed());
+    transformedKey = result;
+    return true;
+}
+
 QVariantMap& Database::publicCustomData()
 {
     return m_data.publicCustomData;
@@ -20,6 +20,7 @@
 #define KEEPASSX_DATABASE_H
 
 #include <QDateTime>
+#include <QFuture>
 #include <QHash>
 #include <QMutex>
 #include <QPointer>
@@ -138,6 +139,7 @@ public:
                 bool updateTransformSalt = false,
                 bool transformKey = true);
     QString keyError();
+    void setPrecomputeNextKey(bool enabled);
     QByteArray challengeResponseKey() const;
     bool challengeMasterSeed(const QByteArray& masterSeed);
     const QUuid& cipher() const;
@@ -153,6 +155,10 @@ public:
     void markAsTemporaryDatabase();
     bool isTemporaryDatabase();
 
+    Entry* findEntryByUuid(const QUuid& uuid, const Group* scope = nullptr, bool recursive = true) const;
+    Group* findGroupByUuid(const QUuid& uuid, const Group* scope = nullptr) const;
+    bool verifyUuidIndex() const;
+
     static Database* databaseByUuid(const QUuid& uuid);
 
 public slots:
@@ -171,6 +177,13 @@ signals:
     void groupRemoved();
     void groupAboutToMove(Group* group, Group* toGroup, int index);
     void groupMoved();
+    void entryAdded(Entry* entry);
+    void entryRemoved(Entry* entry);
+    void entryModified(Entry* entry);
+    // Bracket a Merger run; the structural signals emitted in between can be
+    // handled as one change
+    void aboutToMerge();
+    void merged();
     void databaseOpened();
     void databaseSaved();
     void databaseDiscarded();
@@ -221,8 +234,31 @@ private:
         }
     };
 
+    // KDF seed and transformed key to use for the next save
+    struct NextKey
+    {
+        QSharedPointer<const CompositeKey> key;
+        QSharedPointer<Kdf> kdf;
+        QFuture<QByteArray> transformedKey;
+    };
+
     void createRecycleBin();
 
+    void precomputeNextKey();
+    bool takeNextKey(const QSharedPointer<const CompositeKey>& key, QByteArray& transformedKey);
+
+    void addToUuidIndex(Entry* entry);
+    void addToUuidIndex(Group* group);
+    void removeFromUuidIndex(Entry* entry, const QUuid& uuid);
+    void removeFromUuidIndex(Group* group, const QUuid& uuid);
+
+    void addToEntryIndexes(Entry* entry);
+    void removeFromEntryIndexes(Entry* entry);
+    void updateEntryIndexes(Entry* entry);
+    void updateEntryIndexes(const Group* group);
+    void rebuildEntryIndexes();
+    void onEntryModified();
+
     void startModifiedTimer();
     void stopModifiedTimer();
 
@@ -238,11 +274,40 @@ private:
     QString m_keyError;
     bool m_isTemporaryDatabase = false;
 
+    bool m_precomputeNextKey = false;
+    NextKey m_nextKey;
+    QMutex m_nextKeyMutex;
+
     QStringList m_commonUsernames;
     QStringList m_tagList;
 
+    // Tags and username of every entry as they were counted in the indexes below
+    struct IndexedEntry
+    {
+        QStringList tags;
+        QString username;
+        bool recycled = false;
+
+        bool operator==(const IndexedEntry& other) const;
+    };
+    IndexedEntry indexedEntry(const Entry* entry) const;
+
+    // Reference counted tag (excluding recycled entries) and username indexes
+    QHash<Entry*, IndexedEntry> m_indexedEntries;
+    QHash<QString, int> m_tagCounts;
+    QHash<QString, int> m_usernameCounts;
+    QPointer<Group> m_indexedRecycleBin;
+    bool m_tagCountsChanged = false;
+
+    // Index of all entries and groups connected to this database, excluding history items
+    QMultiHash<QUuid, Entry*> m_entryUuidIndex;
+    QMultiHash<QUuid, Group*> m_groupUuidIndex;
+
     QUuid m_uuid;
     static QHash<QUuid, QPointer<Database>> s_uuidMap;
+
+    friend class Entry;
+    friend class Group;
 };
 
 #endif // KEEPASSX_DATABASE_H
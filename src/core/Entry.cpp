@@ -30,6 +30,7 @@
 #include <QRegularExpression>
 #include <QStringBuilder>
 #include <QUrl>
+#include <QVector>
 
 const int Entry::DefaultIconNumber = 0;
 
@@ -39,8 +40,49 @@ namespace
     const QString AutoTypeSequenceUsername = "{USERNAME}{ENTER}";
     const QString AutoTypeSequencePassword = "{PASSWORD}{ENTER}";
     const QRegularExpression TagDelimiterRegex(R"([,;\t])");
+
+    QRegularExpression windowRegExp(const QString& pattern)
+    {
+        // Regex searching
+        if (pattern.startsWith("//") && pattern.endsWith("//") && pattern.size() >= 4) {
+            return QRegularExpression(pattern.mid(2, pattern.size() - 4), QRegularExpression::CaseInsensitiveOption);
+        }
+
+        // Wildcard searching
+        return Tools::convertToRegex(
+            pattern, Tools::RegexConvertOpts::EXACT_MATCH | Tools::RegexConvertOpts::WILDCARD_UNLIMITED_MATCH);
+    }
+
+    // Values without placeholders resolve to themselves and can be cached as is
+    bool hasPlaceholders(const QString& value)
+    {
+        return value.contains('{');
+    }
 } // namespace
 
+/**
+ * Window matchers built from the entry's associations, title and URL. Each part
+ * is rebuilt only when the data it was built from changes, so repeated global
+ * Auto-Type lookups do not recompile patterns or re-parse URLs.
+ */
+struct Entry::AutoTypeMatcher
+{
+    struct Window
+    {
+        QString pattern;
+        QRegularExpression regExp;
+        bool compiled = false;
+    };
+
+    QList<AutoTypeAssociations::Association> associations;
+    QVector<Window> windows;
+    QString title;
+    QString resolvedTitle;
+    QString url;
+    QString resolvedUrl;
+    QString urlHost;
+};
+
 Entry::Entry()
     : m_attributes(new EntryAttributes(this))
     , m_attachments(new EntryAttachments(this))
@@ -73,6 +115,7 @@ Entry::~Entry()
 
         if (m_group->database()) {
             m_group->database()->addDeletedObject(m_uuid);
+            m_group->database()->updateTagList();
         }
     }
 
@@ -290,6 +333,23 @@ QString Entry::effectiveAutoTypeSequence() const
     return sequence;
 }
 
+Entry::AutoTypeMatcher& Entry::autoTypeMatcher() const
+{
+    if (!m_autoTypeMatcher) {
+        m_autoTypeMatcher.reset(new AutoTypeMatcher());
+    }
+
+    // Unchanged associations share their data with the cached copy, making this check cheap
+    auto& matcher = *m_autoTypeMatcher;
+    const auto associations = m_autoTypeAssociations->getAll();
+    if (matcher.associations != associations) {
+        matcher.associations = associations;
+        matcher.windows = QVector<AutoTypeMatcher::Window>(associations.size());
+    }
+
+    return matcher;
+}
+
 /**
  * Retrieve the Auto-Type sequences matches for a given windowTitle
  * This returns a list with priority ordering. If you don't want duplicates call .toSet() on it.
@@ -301,44 +361,40 @@ QList<QString> Entry::autoTypeSequences(const QString& windowTitle) const
         return {effectiveAutoTypeSequence()};
     }
 
-    // Define helper functions to match window titles
-    auto windowMatches = [&](const QString& pattern) {
-        // Regex searching
-        if (pattern.startsWith("//") && pattern.endsWith("//") && pattern.size() >= 4) {
-            QRegularExpression regExp(pattern.mid(2, pattern.size() - 4), QRegularExpression::CaseInsensitiveOption);
-            return regExp.match(windowTitle).hasMatch();
-        }
+    return autoTypeSequences(windowTitle,
+                             config()->get(Config::AutoTypeEntryTitleMatch).toBool(),
+                             config()->get(Config::AutoTypeEntryURLMatch).toBool());
+}
 
-        // Wildcard searching
-        const auto regExp = Tools::convertToRegex(
-            pattern, Tools::RegexConvertOpts::EXACT_MATCH | Tools::RegexConvertOpts::WILDCARD_UNLIMITED_MATCH);
-        return regExp.match(windowTitle).hasMatch();
-    };
+/**
+ * Sequences of this entry that match the given window title. The title and URL
+ * match settings are passed in so callers checking many entries read them once.
+ */
+QList<QString> Entry::autoTypeSequences(const QString& windowTitle, bool matchTitle, bool matchUrl) const
+{
+    if (windowTitle.isEmpty()) {
+        return {effectiveAutoTypeSequence()};
+    }
 
-    auto windowMatchesTitle = [&](const QString& entryTitle) {
-        return !entryTitle.isEmpty() && windowTitle.contains(entryTitle, Qt::CaseInsensitive);
-    };
+    auto& matcher = autoTypeMatcher();
+    QList<QString> sequenceList;
 
-    auto windowMatchesUrl = [&](const QString& entryUrl) {
-        if (!entryUrl.isEmpty() && windowTitle.contains(entryUrl, Qt::CaseInsensitive)) {
-            return true;
+    // Add window association matches
+    for (int i = 0; i < matcher.associations.size(); ++i) {
+        const auto& assoc = matcher.associations.at(i);
+        if (assoc.window.isEmpty()) {
+            continue;
         }
 
-        QUrl url(entryUrl);
-        if (url.isValid() && !url.host().isEmpty()) {
-            return windowTitle.contains(url.host(), Qt::CaseInsensitive);
+        auto& window = matcher.windows[i];
+        const auto pattern = hasPlaceholders(assoc.window) ? resolveMultiplePlaceholders(assoc.window) : assoc.window;
+        if (!window.compiled || window.pattern != pattern) {
+            window.pattern = pattern;
+            window.regExp = windowRegExp(pattern);
+            window.compiled = true;
         }
 
-        return false;
-    };
-
-    QList<QString> sequenceList;
-
-    // Add window association matches
-    const auto assocList = autoTypeAssociations()->getAll();
-    for (const auto& assoc : assocList) {
-        auto window = resolveMultiplePlaceholders(assoc.window);
-        if (!assoc.window.isEmpty() && windowMatches(window)) {
+        if (window.regExp.match(windowTitle).hasMatch()) {
             if (!assoc.sequence.isEmpty()) {
                 sequenceList << assoc.sequence;
             } else {
@@ -348,13 +404,35 @@ QList<QString> Entry::autoTypeSequences(const QString& windowTitle) const
     }
 
     // Try to match window title
-    if (config()->get(Config::AutoTypeEntryTitleMatch).toBool() && windowMatchesTitle(resolvePlaceholder(title()))) {
-        sequenceList << effectiveAutoTypeSequence();
+    if (matchTitle) {
+        const auto entryTitle = title();
+        if (matcher.title.isNull() || matcher.title != entryTitle || hasPlaceholders(entryTitle)) {
+            matcher.title = entryTitle;
+            matcher.resolvedTitle = resolvePlaceholder(entryTitle);
+        }
+
+        if (!matcher.resolvedTitle.isEmpty() && windowTitle.contains(matcher.resolvedTitle, Qt::CaseInsensitive)) {
+            sequenceList << effectiveAutoTypeSequence();
+        }
     }
 
     // Try to match url in window title
-    if (config()->get(Config::AutoTypeEntryURLMatch).toBool() && windowMatchesUrl(resolvePlaceholder(url()))) {
-        sequenceList << effectiveAutoTypeSequence();
+    if (matchUrl) {
+        const auto entryUrl = url();
+        if (matcher.url.isNull() || matcher.url != entryUrl || hasPlaceholders(entryUrl)) {
+            matcher.url = entryUrl;
+            const auto resolvedUrl = resolvePlaceholder(entryUrl);
+            if (matcher.resolvedUrl != resolvedUrl) {
+                matcher.resolvedUrl = resolvedUrl;
+                const QUrl qurl(resolvedUrl);
+                matcher.urlHost = qurl.isValid() ? qurl.host() : QString();
+            }
+        }
+
+        if ((!matcher.resolvedUrl.isEmpty() && windowTitle.contains(matcher.resolvedUrl, Qt::CaseInsensitive))
+            || (!matcher.urlHost.isEmpty() && windowTitle.contains(matcher.urlHost, Qt::CaseInsensitive))) {
+            sequenceList << effectiveAutoTypeSequence();
+        }
     }
 
     return sequenceList;
@@ -625,7 +703,14 @@ QString Entry::path() const
 void Entry::setUuid(const QUuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
+    auto db = database();
+    if (db && m_uuid != uuid) {
+        db->removeFromUuidIndex(this, m_uuid);
+    }
     set(m_uuid, uuid);
+    if (db) {
+        db->addToUuidIndex(this);
+    }
 }
 
 void Entry::setIcon(int iconNumber)
@@ -1237,7 +1322,9 @@ void Entry::setGroup(Group* group, bool trackPrevious)
         return;
     }
 
+    QPointer<Database> oldDb;
     if (m_group) {
+        oldDb = m_group->database();
         m_group->removeEntry(this);
         if (m_group->database() && m_group->database() != group->database()) {
             setPreviousParentGroup(nullptr);
@@ -1259,6 +1346,11 @@ void Entry::setGroup(Group* group, bool trackPrevious)
     m_group = group;
     group->addEntry(this);
 
+    // Moves within a database only publish the tag list once the entry was added again
+    if (oldDb && oldDb != group->database()) {
+        oldDb->updateTagList();
+    }
+
     if (m_updateTimeinfo) {
         m_data.timeInfo.setLocationChanged(Clock::currentDateTimeUtc());
     }
@@ -96,6 +96,7 @@ public:
     QString defaultAutoTypeSequence() const;
     QString effectiveAutoTypeSequence() const;
     QList<QString> autoTypeSequences(const QString& pattern = {}) const;
+    QList<QString> autoTypeSequences(const QString& windowTitle, bool matchTitle, bool matchUrl) const;
     AutoTypeAssociations* autoTypeAssociations();
     const AutoTypeAssociations* autoTypeAssociations() const;
     QString title() const;
@@ -277,6 +278,9 @@ private slots:
     void updateTotp();
 
 private:
+    struct AutoTypeMatcher;
+
+    AutoTypeMatcher& autoTypeMatcher() const;
     QString resolveMultiplePlaceholdersRecursive(const QString& str, int maxDepth) const;
     QString resolvePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
     QString resolveReferencePlaceholderRecursive(const QString& placeholder, int maxDepth) const;
@@ -299,6 +303,7 @@ private:
     bool m_modifiedSinceBegin;
     QPointer<Group> m_group;
     bool m_updateTimeinfo;
+    mutable QScopedPointer<AutoTypeMatcher> m_autoTypeMatcher;
 };
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Entry::CloneFlags)
@@ -19,6 +19,7 @@
 
 #include "config-keepassx.h"
 #include "core/Global.h"
+#include "crypto/CryptoHash.h"
 #include "crypto/Random.h"
 
 #include <QDesktopServices>
@@ -28,6 +29,20 @@
 #include <QTemporaryFile>
 #include <QUrl>
 
+EntryAttachments::Blob::Blob(const QByteArray& data)
+    : data(data)
+{
+}
+
+QByteArray EntryAttachments::Blob::sha256() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_sha256.isEmpty()) {
+        m_sha256 = CryptoHash::hash(data, CryptoHash::Sha256);
+    }
+    return m_sha256;
+}
+
 EntryAttachments::EntryAttachments(QObject* parent)
     : ModifiableObject(parent)
 {
@@ -50,16 +65,43 @@ bool EntryAttachments::hasKey(const QString& key) const
 
 QSet<QByteArray> EntryAttachments::values() const
 {
-    return asConst(m_attachments).values().toSet();
+    QSet<QByteArray> values;
+    for (const auto& blob : m_attachments) {
+        values.insert(blob->data);
+    }
+    return values;
 }
 
 QByteArray EntryAttachments::value(const QString& key) const
 {
-    return m_attachments.value(key);
+    const auto blob = m_attachments.value(key);
+    return blob ? blob->data : QByteArray();
+}
+
+/**
+ * SHA-256 digest of an attachment's data. The digest is computed once per
+ * blob and shared with every copy of the attachment, so repeated saves only
+ * hash attachments that changed.
+ */
+QByteArray EntryAttachments::hash(const QString& key) const
+{
+    const auto blob = m_attachments.value(key);
+    return blob ? blob->sha256() : QByteArray();
 }
 
 void EntryAttachments::set(const QString& key, const QByteArray& value)
 {
+    setBlob(key, QSharedPointer<const Blob>::create(value));
+}
+
+/**
+ * Set an attachment to data that may be shared with other attachments,
+ * e.g. all attachments referencing the same binary of a database file.
+ */
+void EntryAttachments::setBlob(const QString& key, const QSharedPointer<const Blob>& blob)
+{
+    Q_ASSERT(blob);
+
     bool shouldEmitModified = false;
     bool addAttachment = !m_attachments.contains(key);
 
@@ -67,8 +109,8 @@ void EntryAttachments::set(const QString& key, const QByteArray& value)
         emit aboutToBeAdded(key);
     }
 
-    if (addAttachment || m_attachments.value(key) != value) {
-        m_attachments.insert(key, value);
+    if (addAttachment || m_attachments.value(key)->data != blob->data) {
+        m_attachments.insert(key, blob);
         shouldEmitModified = true;
     }
 
@@ -196,19 +238,31 @@ void EntryAttachments::copyDataFrom(const EntryAttachments* other)
 
 bool EntryAttachments::operator==(const EntryAttachments& other) const
 {
-    return m_attachments == other.m_attachments;
+    if (m_attachments.size() != other.m_attachments.size()) {
+        return false;
+    }
+
+    for (auto it = m_attachments.constBegin(), otherIt = other.m_attachments.constBegin();
+         it != m_attachments.constEnd();
+         ++it, ++otherIt) {
+        if (it.key() != otherIt.key()
+            || (it.value() != otherIt.value() && it.value()->data != otherIt.value()->data)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool EntryAttachments::operator!=(const EntryAttachments& other) const
 {
-    return m_attachments != other.m_attachments;
+    return !(*this == other);
 }
 
 int EntryAttachments::attachmentsSize() const
 {
     int size = 0;
     for (auto it = m_attachments.constBegin(); it != m_attachments.constEnd(); ++it) {
-        size += it.key().toUtf8().size() + it.value().size();
+        size += it.key().toUtf8().size() + it.value()->data.size();
     }
     return size;
 }
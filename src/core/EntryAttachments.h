@@ -23,6 +23,7 @@
 
 #include <QHash>
 #include <QMap>
+#include <QMutex>
 #include <QObject>
 #include <QSharedPointer>
 
@@ -33,13 +34,34 @@ class EntryAttachments : public ModifiableObject
     Q_OBJECT
 
 public:
+    /**
+     * Attachment data shared by all attachments (including history items)
+     * holding it, with its SHA-256 digest computed on first use.
+     */
+    class Blob
+    {
+    public:
+        explicit Blob(const QByteArray& data);
+        QByteArray sha256() const;
+
+        const QByteArray data;
+
+    private:
+        mutable QMutex m_mutex;
+        mutable QByteArray m_sha256;
+
+        Q_DISABLE_COPY(Blob)
+    };
+
     explicit EntryAttachments(QObject* parent = nullptr);
     ~EntryAttachments() override;
     QList<QString> keys() const;
     bool hasKey(const QString& key) const;
     QSet<QByteArray> values() const;
     QByteArray value(const QString& key) const;
+    QByteArray hash(const QString& key) const;
     void set(const QString& key, const QByteArray& value);
+    void setBlob(const QString& key, const QSharedPointer<const Blob>& blob);
     void remove(const QString& key);
     void remove(const QStringList& keys);
     void rename(const QString& key, const QString& newKey);
@@ -67,7 +89,7 @@ private slots:
 private:
     void disconnectAndEraseExternalFile(const QString& path);
 
-    QMap<QString, QByteArray> m_attachments;
+    QMap<QString, QSharedPointer<const Blob>> m_attachments;
     QHash<QString, QString> m_openedAttachments;
     QHash<QString, QString> m_openedAttachmentsInverse;
     QHash<QString, QSharedPointer<FileWatcher>> m_attachmentFileWatchers;
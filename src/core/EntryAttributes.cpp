@@ -18,6 +18,7 @@
 
 #include "EntryAttributes.h"
 #include "core/Global.h"
+#include "format/KeePass2RandomStream.h"
 
 #include <QRegularExpression>
 #include <QUuid>
@@ -37,6 +38,86 @@ const QString EntryAttributes::RememberCmdExecAttr = "_EXEC_CMD";
 const QString EntryAttributes::AdditionalUrlAttribute = "KP2A_URL";
 const QString EntryAttributes::PasskeyAttribute = "KPEX_PASSKEY";
 
+EntryAttributes::LazyValue::LazyValue(const QByteArray& ciphertext,
+                                      quint64 position,
+                                      QSharedPointer<const KeePass2RandomStream> stream)
+    : m_ciphertext(ciphertext)
+    , m_stream(std::move(stream))
+    , m_position(position)
+{
+}
+
+/**
+ * Decrypted value. If decryption fails, the value stays encrypted, an
+ * empty string is returned and ok (if given) is set to false.
+ */
+QString EntryAttributes::LazyValue::value(bool* ok) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_decrypted) {
+        QByteArray plaintext;
+        if (!decrypt(plaintext)) {
+            if (ok) {
+                *ok = false;
+            }
+            return {};
+        }
+        m_value = QString::fromUtf8(plaintext);
+        m_decrypted = true;
+        m_ciphertext.clear();
+        m_stream.reset();
+    }
+    if (ok) {
+        *ok = true;
+    }
+    return m_value;
+}
+
+/**
+ * UTF-8 encoded value. Does not keep the plaintext around if the value
+ * was not accessed before.
+ */
+QByteArray EntryAttributes::LazyValue::toUtf8(bool* ok) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_decrypted) {
+        if (ok) {
+            *ok = true;
+        }
+        return m_value.toUtf8();
+    }
+
+    QByteArray plaintext;
+    const bool decrypted = decrypt(plaintext);
+    if (ok) {
+        *ok = decrypted;
+    }
+    return plaintext;
+}
+
+/**
+ * Size of the UTF-8 encoded value
+ */
+int EntryAttributes::LazyValue::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_decrypted) {
+        return m_value.toUtf8().size();
+    }
+    return m_ciphertext.size();
+}
+
+bool EntryAttributes::LazyValue::decrypt(QByteArray& plaintext) const
+{
+    plaintext = m_ciphertext;
+    if (!m_stream || !m_stream->processAt(plaintext, m_position)) {
+        qWarning("EntryAttributes: Failed to decrypt protected value");
+        plaintext.clear();
+        return false;
+    }
+    return true;
+}
+
 EntryAttributes::EntryAttributes(QObject* parent)
     : ModifiableObject(parent)
 {
@@ -87,16 +168,43 @@ QList<QString> EntryAttributes::customKeys() const
     return customKeys;
 }
 
-QString EntryAttributes::value(const QString& key) const
+/**
+ * Value of an attribute. ok (if given) is set to false if a protected
+ * value could not be decrypted.
+ */
+QString EntryAttributes::value(const QString& key, bool* ok) const
 {
+    const auto lazyValue = m_lazyValues.value(key);
+    if (lazyValue) {
+        return lazyValue->value(ok);
+    }
+    if (ok) {
+        *ok = true;
+    }
     return m_attributes.value(key);
 }
 
+/**
+ * UTF-8 encoded value of an attribute. Protected values that were not
+ * accessed yet are decrypted without keeping the plaintext in memory.
+ */
+QByteArray EntryAttributes::valueUtf8(const QString& key, bool* ok) const
+{
+    const auto lazyValue = m_lazyValues.value(key);
+    if (lazyValue) {
+        return lazyValue->toUtf8(ok);
+    }
+    if (ok) {
+        *ok = true;
+    }
+    return m_attributes.value(key).toUtf8();
+}
+
 QList<QString> EntryAttributes::values(const QList<QString>& keys) const
 {
     QList<QString> values;
     for (const QString& key : keys) {
-        values.append(m_attributes.value(key));
+        values.append(value(key));
     }
     return values;
 }
@@ -108,7 +216,12 @@ bool EntryAttributes::contains(const QString& key) const
 
 bool EntryAttributes::containsValue(const QString& value) const
 {
-    return asConst(m_attributes).values().contains(value);
+    for (auto it = m_attributes.constBegin(); it != m_attributes.constEnd(); ++it) {
+        if (this->value(it.key()) == value) {
+            return true;
+        }
+    }
+    return false;
 }
 
 bool EntryAttributes::isProtected(const QString& key) const
@@ -132,7 +245,7 @@ void EntryAttributes::set(const QString& key, const QString& value, bool protect
     bool shouldEmitModified = false;
 
     bool addAttribute = !m_attributes.contains(key);
-    bool changeValue = !addAttribute && (m_attributes.value(key) != value);
+    bool changeValue = !addAttribute && (this->value(key) != value);
     bool defaultAttribute = isDefaultAttribute(key);
 
     if (addAttribute && !defaultAttribute) {
@@ -141,6 +254,7 @@ void EntryAttributes::set(const QString& key, const QString& value, bool protect
 
     if (addAttribute || changeValue) {
         m_attributes.insert(key, value);
+        m_lazyValues.remove(key);
         shouldEmitModified = true;
     }
 
@@ -166,6 +280,34 @@ void EntryAttributes::set(const QString& key, const QString& value, bool protect
     }
 }
 
+/**
+ * Set a protected value that is decrypted when it is accessed for the first time.
+ * Used while reading database files.
+ */
+void EntryAttributes::setLazy(const QString& key, const QSharedPointer<const LazyValue>& value)
+{
+    bool addAttribute = !m_attributes.contains(key);
+    bool defaultAttribute = isDefaultAttribute(key);
+
+    if (addAttribute && !defaultAttribute) {
+        emit aboutToBeAdded(key);
+    }
+
+    m_attributes.insert(key, {});
+    m_lazyValues.insert(key, value);
+    m_protectedAttributes.insert(key);
+
+    emitModified();
+
+    if (defaultAttribute) {
+        emit defaultKeyModified();
+    } else if (addAttribute) {
+        emit added(key);
+    } else {
+        emit customKeyModified(key);
+    }
+}
+
 void EntryAttributes::remove(const QString& key)
 {
     Q_ASSERT(!isDefaultAttribute(key));
@@ -178,6 +320,7 @@ void EntryAttributes::remove(const QString& key)
 
     m_attributes.remove(key);
     m_protectedAttributes.remove(key);
+    m_lazyValues.remove(key);
 
     emit removed(key);
     emitModified();
@@ -205,6 +348,7 @@ void EntryAttributes::rename(const QString& oldKey, const QString& newKey)
 
     m_attributes.remove(oldKey);
     m_attributes.insert(newKey, data);
+    m_lazyValues.remove(oldKey);
     if (protect) {
         m_protectedAttributes.remove(oldKey);
         m_protectedAttributes.insert(newKey);
@@ -228,13 +372,17 @@ void EntryAttributes::copyCustomKeysFrom(const EntryAttributes* other)
         if (!isDefaultAttribute(key)) {
             m_attributes.remove(key);
             m_protectedAttributes.remove(key);
+            m_lazyValues.remove(key);
         }
     }
 
     const QList<QString> otherKeyList = other->keys();
     for (const QString& key : otherKeyList) {
         if (!isDefaultAttribute(key)) {
-            m_attributes.insert(key, other->value(key));
+            m_attributes.insert(key, other->m_attributes.value(key));
+            if (other->m_lazyValues.contains(key)) {
+                m_lazyValues.insert(key, other->m_lazyValues.value(key));
+            }
             if (other->isProtected(key)) {
                 m_protectedAttributes.insert(key);
             }
@@ -273,6 +421,7 @@ void EntryAttributes::copyDataFrom(const EntryAttributes* other)
 
         m_attributes = other->m_attributes;
         m_protectedAttributes = other->m_protectedAttributes;
+        m_lazyValues = other->m_lazyValues;
 
         emit reset();
         emitModified();
@@ -299,12 +448,30 @@ QUuid EntryAttributes::referenceUuid(const QString& key) const
 
 bool EntryAttributes::operator==(const EntryAttributes& other) const
 {
-    return (m_attributes == other.m_attributes && m_protectedAttributes == other.m_protectedAttributes);
+    if (m_lazyValues.isEmpty() && other.m_lazyValues.isEmpty()) {
+        return (m_attributes == other.m_attributes && m_protectedAttributes == other.m_protectedAttributes);
+    }
+
+    if (m_protectedAttributes != other.m_protectedAttributes || m_attributes.keys() != other.m_attributes.keys()) {
+        return false;
+    }
+
+    for (auto it = m_attributes.constBegin(); it != m_attributes.constEnd(); ++it) {
+        // Shared lazy values are equal without decrypting them
+        const auto lazyValue = m_lazyValues.value(it.key());
+        if (lazyValue && lazyValue == other.m_lazyValues.value(it.key())) {
+            continue;
+        }
+        if (value(it.key()) != other.value(it.key())) {
+            return false;
+        }
+    }
+    return true;
 }
 
 bool EntryAttributes::operator!=(const EntryAttributes& other) const
 {
-    return (m_attributes != other.m_attributes || m_protectedAttributes != other.m_protectedAttributes);
+    return !(*this == other);
 }
 
 QRegularExpressionMatch EntryAttributes::matchReference(const QString& text)
@@ -322,6 +489,7 @@ void EntryAttributes::clear()
 
     m_attributes.clear();
     m_protectedAttributes.clear();
+    m_lazyValues.clear();
 
     for (const QString& key : DefaultAttributes) {
         m_attributes.insert(key, "");
@@ -335,7 +503,8 @@ int EntryAttributes::attributesSize() const
 {
     int size = 0;
     for (auto it = m_attributes.constBegin(); it != m_attributes.constEnd(); ++it) {
-        size += it.key().toUtf8().size() + it.value().toUtf8().size();
+        const auto lazyValue = m_lazyValues.value(it.key());
+        size += it.key().toUtf8().size() + (lazyValue ? lazyValue->size() : it.value().toUtf8().size());
     }
     return size;
 }
@@ -20,29 +20,60 @@
 #define KEEPASSX_ENTRYATTRIBUTES_H
 
 #include <QMap>
+#include <QMutex>
 #include <QObject>
 #include <QSet>
+#include <QSharedPointer>
 
 #include "core/ModifiableObject.h"
 
+class KeePass2RandomStream;
+
 class EntryAttributes : public ModifiableObject
 {
     Q_OBJECT
 
 public:
+    /**
+     * Protected value that stays encrypted with the inner random stream of the
+     * database file it was read from until it is accessed for the first time.
+     */
+    class LazyValue
+    {
+    public:
+        LazyValue(const QByteArray& ciphertext, quint64 position, QSharedPointer<const KeePass2RandomStream> stream);
+        QString value(bool* ok = nullptr) const;
+        QByteArray toUtf8(bool* ok = nullptr) const;
+        int size() const;
+
+    private:
+        bool decrypt(QByteArray& plaintext) const;
+
+        mutable QMutex m_mutex;
+        mutable bool m_decrypted = false;
+        mutable QString m_value;
+        mutable QByteArray m_ciphertext;
+        mutable QSharedPointer<const KeePass2RandomStream> m_stream;
+        const quint64 m_position;
+
+        Q_DISABLE_COPY(LazyValue)
+    };
+
     explicit EntryAttributes(QObject* parent = nullptr);
     QList<QString> keys() const;
     bool hasKey(const QString& key) const;
     bool hasPasskey() const;
     void removePasskeyAttributes();
     QList<QString> customKeys() const;
-    QString value(const QString& key) const;
+    QString value(const QString& key, bool* ok = nullptr) const;
+    QByteArray valueUtf8(const QString& key, bool* ok = nullptr) const;
     QList<QString> values(const QList<QString>& keys) const;
     bool contains(const QString& key) const;
     bool containsValue(const QString& value) const;
     bool isProtected(const QString& key) const;
     bool isReference(const QString& key) const;
     void set(const QString& key, const QString& value, bool protect = false);
+    void setLazy(const QString& key, const QSharedPointer<const LazyValue>& value);
     void remove(const QString& key);
     void rename(const QString& oldKey, const QString& newKey);
     void copyCustomKeysFrom(const EntryAttributes* other);
@@ -87,6 +118,8 @@ signals:
 private:
     QMap<QString, QString> m_attributes;
     QSet<QString> m_protectedAttributes;
+    // Protected values read from a database file, their entries in m_attributes stay empty
+    QMap<QString, QSharedPointer<const LazyValue>> m_lazyValues;
 };
 
 #endif // KEEPASSX_ENTRYATTRIBUTES_H
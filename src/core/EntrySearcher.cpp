@@ -70,7 +70,7 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
     Q_ASSERT(baseGroup);
 
     QList<Entry*> results;
-    for (const auto group : baseGroup->groupsRecursive(true)) {
+    baseGroup->forEachGroupRecursive([&](const Group* group) {
         if (forceSearch || group->resolveSearchingEnabled()) {
             for (const auto entry : group->entries()) {
                 if (searchEntryImpl(entry)) {
@@ -78,7 +78,7 @@ QList<Entry*> EntrySearcher::repeat(const Group* baseGroup, bool forceSearch)
                 }
             }
         }
-    }
+    });
     return results;
 }
 
@@ -48,6 +48,11 @@ Group::Group()
     m_data.mergeMode = Default;
 
     connect(m_customData, &CustomData::modified, this, &Group::modified);
+    // Only adding or removing keys changes which group a value is inherited from
+    connect(m_customData, &CustomData::added, this, &Group::invalidateResolvedProperties);
+    connect(m_customData, &CustomData::removed, this, &Group::invalidateResolvedProperties);
+    connect(m_customData, &CustomData::renamed, this, &Group::invalidateResolvedProperties);
+    connect(m_customData, &CustomData::reset, this, &Group::invalidateResolvedProperties);
     connect(this, &Group::modified, this, &Group::updateTimeinfo);
     connect(this, &Group::groupNonDataChange, this, &Group::updateTimeinfo);
 }
@@ -55,6 +60,9 @@ Group::Group()
 Group::~Group()
 {
     setUpdateTimeinfo(false);
+    if (m_db) {
+        m_db->removeFromUuidIndex(this, m_uuid);
+    }
     // Destroy entries and children manually so DeletedObjects can be added
     // to database.
     const QList<Entry*> entries = m_entries;
@@ -222,19 +230,20 @@ Entry* Group::lastTopVisibleEntry() const
 
 bool Group::isRecycled() const
 {
-    auto group = this;
-    auto db = group->database();
-    if (db) {
-        auto recycleBin = db->metadata()->recycleBin();
-        do {
-            if (group == recycleBin) {
-                return true;
-            }
-            group = group->m_parent;
-        } while (group);
+    auto db = database();
+    if (!db) {
+        return false;
+    }
+
+    // The cached flag is only valid for the recycle bin it was resolved against
+    auto recycleBin = db->metadata()->recycleBin();
+    if (!(m_resolved.valid & ResolvedRecycled) || m_resolved.recycleBin != recycleBin) {
+        m_resolved.recycled = (this == recycleBin) || (m_parent && m_parent->isRecycled());
+        m_resolved.recycleBin = recycleBin;
+        m_resolved.valid |= ResolvedRecycled;
     }
 
-    return false;
+    return m_resolved.recycled;
 }
 
 bool Group::isExpired() const
@@ -260,15 +269,12 @@ const CustomData* Group::customData() const
 Group::TriState Group::resolveCustomDataTriState(const QString& key, bool checkParent) const
 {
     // If not defined, check our parent up to the root group
-    if (!m_customData->contains(key)) {
-        if (!m_parent || !checkParent) {
-            return Inherit;
-        } else {
-            return m_parent->resolveCustomDataTriState(key);
-        }
+    auto owner = checkParent ? resolveCustomDataOwner(key) : this;
+    if (!owner || !owner->m_customData->contains(key)) {
+        return Inherit;
     }
 
-    return m_customData->value(key) == TRUE_STR ? Enable : Disable;
+    return owner->m_customData->value(key) == TRUE_STR ? Enable : Disable;
 }
 
 void Group::setCustomDataTriState(const QString& key, const Group::TriState& value)
@@ -290,15 +296,46 @@ void Group::setCustomDataTriState(const QString& key, const Group::TriState& val
 QString Group::resolveCustomDataString(const QString& key, bool checkParent) const
 {
     // If not defined, check our parent up to the root group
-    if (!m_customData->contains(key)) {
-        if (!m_parent || !checkParent) {
-            return QString();
-        } else {
-            return m_parent->resolveCustomDataString(key);
-        }
+    auto owner = checkParent ? resolveCustomDataOwner(key) : this;
+    if (!owner || !owner->m_customData->contains(key)) {
+        return QString();
     }
 
-    return m_customData->value(key);
+    return owner->m_customData->value(key);
+}
+
+/**
+ * Returns the closest group up to the root group that defines the custom data key,
+ * or nullptr if no group defines it.
+ */
+const Group* Group::resolveCustomDataOwner(const QString& key) const
+{
+    auto it = m_resolved.customDataOwners.constFind(key);
+    if (it != m_resolved.customDataOwners.constEnd()) {
+        return it.value();
+    }
+
+    const Group* owner = nullptr;
+    if (m_customData->contains(key)) {
+        owner = this;
+    } else if (m_parent) {
+        owner = m_parent->resolveCustomDataOwner(key);
+    }
+    m_resolved.customDataOwners.insert(key, owner);
+    return owner;
+}
+
+void Group::invalidateResolvedProperties()
+{
+    // Descendants only resolve through their parents, so nothing below an unresolved group is cached
+    if (m_resolved.valid == 0 && m_resolved.customDataOwners.isEmpty()) {
+        return;
+    }
+
+    m_resolved = {};
+    for (Group* group : asConst(m_children)) {
+        group->invalidateResolvedProperties();
+    }
 }
 
 bool Group::equals(const Group* other, CompareItemOptions options) const
@@ -336,7 +373,13 @@ bool Group::equals(const Group* other, CompareItemOptions options) const
 
 void Group::setUuid(const QUuid& uuid)
 {
+    if (m_db && m_uuid != uuid) {
+        m_db->removeFromUuidIndex(this, m_uuid);
+    }
     set(m_uuid, uuid);
+    if (m_db) {
+        m_db->addToUuidIndex(this);
+    }
 }
 
 void Group::setName(const QString& name)
@@ -396,12 +439,16 @@ void Group::setDefaultAutoTypeSequence(const QString& sequence)
 
 void Group::setAutoTypeEnabled(TriState enable)
 {
-    set(m_data.autoTypeEnabled, enable);
+    if (set(m_data.autoTypeEnabled, enable)) {
+        invalidateResolvedProperties();
+    }
 }
 
 void Group::setSearchingEnabled(TriState enable)
 {
-    set(m_data.searchingEnabled, enable);
+    if (set(m_data.searchingEnabled, enable)) {
+        invalidateResolvedProperties();
+    }
 }
 
 void Group::setLastTopVisibleEntry(Entry* entry)
@@ -462,8 +509,10 @@ void Group::setParent(Group* parent, int index, bool trackPrevious)
     }
 
     if (!moveWithinDatabase) {
+        QPointer<Database> oldDb = m_db;
         cleanupParent();
         m_parent = parent;
+        invalidateResolvedProperties();
         if (m_db) {
             setPreviousParentGroup(nullptr);
             recCreateDelObjects();
@@ -476,21 +525,35 @@ void Group::setParent(Group* parent, int index, bool trackPrevious)
         }
         if (m_db != parent->m_db) {
             connectDatabaseSignalsRecursive(parent->m_db);
+            if (oldDb) {
+                oldDb->updateTagList();
+            }
+            if (m_db) {
+                m_db->updateTagList();
+            }
         }
         QObject::setParent(parent);
         emit groupAboutToAdd(this, index);
         Q_ASSERT(index <= parent->m_children.size());
         parent->m_children.insert(index, this);
     } else {
+        bool wasRecycled = isRecycled();
         emit aboutToMove(this, parent, index);
         if (trackPrevious && m_parent != parent) {
             setPreviousParentGroup(m_parent);
         }
         m_parent->m_children.removeAll(this);
         m_parent = parent;
+        invalidateResolvedProperties();
         QObject::setParent(parent);
         Q_ASSERT(index <= parent->m_children.size());
         parent->m_children.insert(index, this);
+
+        // Tags of recycled entries are not indexed
+        if (isRecycled() != wasRecycled) {
+            m_db->updateEntryIndexes(this);
+            m_db->updateTagList();
+        }
     }
 
     if (m_updateTimeinfo) {
@@ -514,6 +577,7 @@ void Group::setParent(Database* db)
     cleanupParent();
 
     m_parent = nullptr;
+    invalidateResolvedProperties();
     connectDatabaseSignalsRecursive(db);
 
     QObject::setParent(db);
@@ -583,19 +647,7 @@ const QList<Entry*>& Group::entries() const
 QList<Entry*> Group::entriesRecursive(bool includeHistoryItems) const
 {
     QList<Entry*> entryList;
-
-    entryList.append(m_entries);
-
-    if (includeHistoryItems) {
-        for (Entry* entry : m_entries) {
-            entryList.append(entry->historyItems());
-        }
-    }
-
-    for (Group* group : m_children) {
-        entryList.append(group->entriesRecursive(includeHistoryItems));
-    }
-
+    forEachEntryRecursive([&entryList](Entry* entry) { entryList.append(entry); }, includeHistoryItems);
     return entryList;
 }
 
@@ -612,18 +664,28 @@ Entry* Group::findEntryByUuid(const QUuid& uuid, bool recursive) const
         return nullptr;
     }
 
-    auto entries = m_entries;
-    if (recursive) {
-        entries = entriesRecursive(false);
+    if (m_db) {
+        return m_db->findEntryByUuid(uuid, this, recursive);
     }
 
-    for (auto entry : entries) {
-        if (entry->uuid() == uuid) {
-            return entry;
+    if (!recursive) {
+        for (auto entry : m_entries) {
+            if (entry->uuid() == uuid) {
+                return entry;
+            }
         }
+        return nullptr;
     }
 
-    return nullptr;
+    Entry* result = nullptr;
+    forEachEntryRecursive([&](Entry* entry) {
+        if (entry->uuid() == uuid) {
+            result = entry;
+            return false;
+        }
+        return true;
+    });
+    return result;
 }
 
 Entry* Group::findEntryByPath(const QString& entryPath) const
@@ -647,45 +709,43 @@ Entry* Group::findEntryBySearchTerm(const QString& term, EntryReferenceType refe
                "Database::findEntryRecursive",
                "Can't search entry with \"referenceType\" parameter equal to \"Unknown\"");
 
-    const QList<Group*> groups = groupsRecursive(true);
-
-    for (const Group* group : groups) {
+    Entry* result = nullptr;
+    forEachEntryRecursive([&](Entry* entry) {
         bool found = false;
-        const QList<Entry*>& entryList = group->entries();
-        for (Entry* entry : entryList) {
-            switch (referenceType) {
-            case EntryReferenceType::Unknown:
-                return nullptr;
-            case EntryReferenceType::Title:
-                found = entry->title() == term;
-                break;
-            case EntryReferenceType::UserName:
-                found = entry->username() == term;
-                break;
-            case EntryReferenceType::Password:
-                found = entry->password() == term;
-                break;
-            case EntryReferenceType::Url:
-                found = entry->url() == term;
-                break;
-            case EntryReferenceType::Notes:
-                found = entry->notes() == term;
-                break;
-            case EntryReferenceType::QUuid:
-                found = entry->uuid() == QUuid::fromRfc4122(QByteArray::fromHex(term.toLatin1()));
-                break;
-            case EntryReferenceType::CustomAttributes:
-                found = entry->attributes()->containsValue(term);
-                break;
-            }
+        switch (referenceType) {
+        case EntryReferenceType::Unknown:
+            return false;
+        case EntryReferenceType::Title:
+            found = entry->title() == term;
+            break;
+        case EntryReferenceType::UserName:
+            found = entry->username() == term;
+            break;
+        case EntryReferenceType::Password:
+            found = entry->password() == term;
+            break;
+        case EntryReferenceType::Url:
+            found = entry->url() == term;
+            break;
+        case EntryReferenceType::Notes:
+            found = entry->notes() == term;
+            break;
+        case EntryReferenceType::QUuid:
+            found = entry->uuid() == QUuid::fromRfc4122(QByteArray::fromHex(term.toLatin1()));
+            break;
+        case EntryReferenceType::CustomAttributes:
+            found = entry->attributes()->containsValue(term);
+            break;
+        }
 
-            if (found) {
-                return entry;
-            }
+        if (found) {
+            result = entry;
+            return false;
         }
-    }
+        return true;
+    });
 
-    return nullptr;
+    return result;
 }
 
 Entry* Group::findEntryByPathRecursive(const QString& entryPath, const QString& basePath) const
@@ -786,28 +846,14 @@ QString Group::print(bool recursive, bool flatten, int depth)
 QList<const Group*> Group::groupsRecursive(bool includeSelf) const
 {
     QList<const Group*> groupList;
-    if (includeSelf) {
-        groupList.append(this);
-    }
-
-    for (const Group* group : asConst(m_children)) {
-        groupList.append(group->groupsRecursive(true));
-    }
-
+    forEachGroupRecursive([&groupList](const Group* group) { groupList.append(group); }, includeSelf);
     return groupList;
 }
 
 QList<Group*> Group::groupsRecursive(bool includeSelf)
 {
     QList<Group*> groupList;
-    if (includeSelf) {
-        groupList.append(this);
-    }
-
-    for (Group* group : asConst(m_children)) {
-        groupList.append(group->groupsRecursive(true));
-    }
-
+    forEachGroupRecursive([&groupList](Group* group) { groupList.append(group); }, includeSelf);
     return groupList;
 }
 
@@ -815,20 +861,19 @@ QSet<QUuid> Group::customIconsRecursive() const
 {
     QSet<QUuid> result;
 
-    if (!iconUuid().isNull()) {
-        result.insert(iconUuid());
-    }
-
-    const QList<Entry*> entryList = entriesRecursive(true);
-    for (Entry* entry : entryList) {
-        if (!entry->iconUuid().isNull()) {
-            result.insert(entry->iconUuid());
+    forEachGroupRecursive([&result](const Group* group) {
+        if (!group->iconUuid().isNull()) {
+            result.insert(group->iconUuid());
         }
-    }
+    });
 
-    for (Group* group : m_children) {
-        result.unite(group->customIconsRecursive());
-    }
+    forEachEntryRecursive(
+        [&result](const Entry* entry) {
+            if (!entry->iconUuid().isNull()) {
+                result.insert(entry->iconUuid());
+            }
+        },
+        true);
 
     return result;
 }
@@ -837,12 +882,12 @@ QList<QString> Group::usernamesRecursive(int topN) const
 {
     // Collect all usernames and sort for easy counting
     QHash<QString, int> countedUsernames;
-    for (const auto* entry : entriesRecursive()) {
+    forEachEntryRecursive([&countedUsernames](const Entry* entry) {
         const auto username = entry->username();
         if (!username.isEmpty() && !entry->isAttributeReference(EntryAttributes::UserNameKey)) {
             countedUsernames.insert(username, ++countedUsernames[username]);
         }
-    }
+    });
 
     // Sort username/frequency pairs by frequency and name
     QList<QPair<QString, int>> sortedUsernames;
@@ -875,13 +920,19 @@ Group* Group::findGroupByUuid(const QUuid& uuid)
         return nullptr;
     }
 
-    for (Group* group : groupsRecursive(true)) {
-        if (group->uuid() == uuid) {
-            return group;
-        }
+    if (m_db) {
+        return m_db->findGroupByUuid(uuid, this);
     }
 
-    return nullptr;
+    Group* result = nullptr;
+    forEachGroupRecursive([&](Group* group) {
+        if (group->uuid() == uuid) {
+            result = group;
+            return false;
+        }
+        return true;
+    });
+    return result;
 }
 
 const Group* Group::findGroupByUuid(const QUuid& uuid) const
@@ -890,13 +941,19 @@ const Group* Group::findGroupByUuid(const QUuid& uuid) const
         return nullptr;
     }
 
-    for (const Group* group : groupsRecursive(true)) {
-        if (group->uuid() == uuid) {
-            return group;
-        }
+    if (m_db) {
+        return m_db->findGroupByUuid(uuid, this);
     }
 
-    return nullptr;
+    const Group* result = nullptr;
+    forEachGroupRecursive([&](const Group* group) {
+        if (group->uuid() == uuid) {
+            result = group;
+            return false;
+        }
+        return true;
+    });
+    return result;
 }
 
 Group* Group::findChildByName(const QString& name)
@@ -964,6 +1021,7 @@ Group* Group::clone(Entry::CloneFlags entryFlags, Group::CloneFlags groupFlags)
 void Group::copyDataFrom(const Group* other)
 {
     if (set(m_data, other->m_data)) {
+        invalidateResolvedProperties();
         emit groupDataChanged(this);
     }
     m_customData->copyDataFrom(other->m_customData);
@@ -980,7 +1038,12 @@ void Group::addEntry(Entry* entry)
     m_entries << entry;
     connect(entry, &Entry::entryDataChanged, this, &Group::entryDataChanged);
     if (m_db) {
-        connect(entry, &Entry::modified, m_db, &Database::markAsModified);
+        Database* db = m_db;
+        connect(entry, &Entry::modified, db, &Database::markAsModified);
+        connect(entry, &Entry::modified, db, &Database::onEntryModified);
+        db->addToUuidIndex(entry);
+        db->addToEntryIndexes(entry);
+        db->updateTagList();
     }
 
     emitModified();
@@ -998,6 +1061,8 @@ void Group::removeEntry(Entry* entry)
     entry->disconnect(this);
     if (m_db) {
         entry->disconnect(m_db);
+        m_db->removeFromUuidIndex(entry, entry->uuid());
+        m_db->removeFromEntryIndexes(entry);
     }
     m_entries.removeAll(entry);
     emitModified();
@@ -1034,14 +1099,19 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
 {
     if (m_db) {
         disconnect(m_db);
+        m_db->removeFromUuidIndex(this, m_uuid);
     }
 
     for (Entry* entry : asConst(m_entries)) {
         if (m_db) {
             entry->disconnect(m_db);
+            m_db->removeFromUuidIndex(entry, entry->uuid());
+            m_db->removeFromEntryIndexes(entry);
         }
         if (db) {
             connect(entry, &Entry::modified, db, &Database::markAsModified);
+            connect(entry, &Entry::modified, db, &Database::onEntryModified);
+            db->addToUuidIndex(entry);
         }
     }
 
@@ -1054,13 +1124,23 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
         connect(this, &Group::groupAdded, db, &Database::groupAdded);
         connect(this, &Group::aboutToMove, db, &Database::groupAboutToMove);
         connect(this, &Group::groupMoved, db, &Database::groupMoved);
+        connect(this, &Group::entryAdded, db, &Database::entryAdded);
+        connect(this, &Group::entryRemoved, db, &Database::entryRemoved);
         connect(this, &Group::groupNonDataChange, db, &Database::markNonDataChange);
         connect(this, &Group::modified, db, &Database::markAsModified);
         // clang-format on
+        db->addToUuidIndex(this);
     }
 
     m_db = db;
 
+    // Index entries once the group belongs to the database so recycled entries are detected
+    if (db) {
+        for (Entry* entry : asConst(m_entries)) {
+            db->addToEntryIndexes(entry);
+        }
+    }
+
     for (Group* group : asConst(m_children)) {
         group->connectDatabaseSignalsRecursive(db);
     }
@@ -1092,40 +1172,48 @@ void Group::recCreateDelObjects()
 
 bool Group::resolveSearchingEnabled() const
 {
-    switch (m_data.searchingEnabled) {
-    case Inherit:
-        if (!m_parent) {
-            return true;
-        } else {
-            return m_parent->resolveSearchingEnabled();
+    if (!(m_resolved.valid & ResolvedSearchingEnabled)) {
+        switch (m_data.searchingEnabled) {
+        case Inherit:
+            m_resolved.searchingEnabled = !m_parent || m_parent->resolveSearchingEnabled();
+            break;
+        case Enable:
+            m_resolved.searchingEnabled = true;
+            break;
+        case Disable:
+            m_resolved.searchingEnabled = false;
+            break;
+        default:
+            Q_ASSERT(false);
+            return false;
         }
-    case Enable:
-        return true;
-    case Disable:
-        return false;
-    default:
-        Q_ASSERT(false);
-        return false;
+        m_resolved.valid |= ResolvedSearchingEnabled;
     }
+
+    return m_resolved.searchingEnabled;
 }
 
 bool Group::resolveAutoTypeEnabled() const
 {
-    switch (m_data.autoTypeEnabled) {
-    case Inherit:
-        if (!m_parent) {
-            return true;
-        } else {
-            return m_parent->resolveAutoTypeEnabled();
+    if (!(m_resolved.valid & ResolvedAutoTypeEnabled)) {
+        switch (m_data.autoTypeEnabled) {
+        case Inherit:
+            m_resolved.autoTypeEnabled = !m_parent || m_parent->resolveAutoTypeEnabled();
+            break;
+        case Enable:
+            m_resolved.autoTypeEnabled = true;
+            break;
+        case Disable:
+            m_resolved.autoTypeEnabled = false;
+            break;
+        default:
+            Q_ASSERT(false);
+            return false;
         }
-    case Enable:
-        return true;
-    case Disable:
-        return false;
-    default:
-        Q_ASSERT(false);
-        return false;
+        m_resolved.valid |= ResolvedAutoTypeEnabled;
     }
+
+    return m_resolved.autoTypeEnabled;
 }
 
 Entry* Group::addEntryWithPath(const QString& entryPath)
@@ -1191,16 +1279,12 @@ void Group::applyGroupIconTo(Group* other)
 
 void Group::applyGroupIconToChildGroups()
 {
-    for (Group* recursiveChild : groupsRecursive(false)) {
-        applyGroupIconTo(recursiveChild);
-    }
+    forEachGroupRecursive([this](Group* recursiveChild) { applyGroupIconTo(recursiveChild); }, false);
 }
 
 void Group::applyGroupIconToChildEntries()
 {
-    for (Entry* recursiveEntry : entriesRecursive(false)) {
-        applyGroupIconTo(recursiveEntry);
-    }
+    forEachEntryRecursive([this](Entry* recursiveEntry) { applyGroupIconTo(recursiveEntry); });
 }
 
 void Group::sortChildrenRecursively(bool reverse)
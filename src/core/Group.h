@@ -158,6 +158,9 @@ public:
     QList<Entry*> entriesRecursive(bool includeHistoryItems = false) const;
     QList<const Group*> groupsRecursive(bool includeSelf) const;
     QList<Group*> groupsRecursive(bool includeSelf);
+    template <typename Visitor> bool forEachEntryRecursive(Visitor&& visitor, bool includeHistoryItems = false) const;
+    template <typename Visitor> bool forEachGroupRecursive(Visitor&& visitor, bool includeSelf = true) const;
+    template <typename Visitor> bool forEachGroupRecursive(Visitor&& visitor, bool includeSelf = true);
     QSet<QUuid> customIconsRecursive() const;
     QList<QString> usernamesRecursive(int topN = -1) const;
 
@@ -204,12 +207,15 @@ private slots:
 
 private:
     template <class P, class V> bool set(P& property, const V& value);
+    template <typename Visitor, typename T> static bool visit(Visitor& visitor, T item);
 
     void setParent(Database* db);
 
     void connectDatabaseSignalsRecursive(Database* db);
     void cleanupParent();
     void recCreateDelObjects();
+    const Group* resolveCustomDataOwner(const QString& key) const;
+    void invalidateResolvedProperties();
 
     Entry* findEntryByPathRecursive(const QString& entryPath, const QString& basePath) const;
     Group* findGroupByPathRecursive(const QString& groupPath, const QString& basePath);
@@ -225,6 +231,25 @@ private:
 
     QPointer<Group> m_parent;
 
+    // Properties inherited through the parent chain, resolved on first use and
+    // invalidated top-down whenever the hierarchy or the inherited data changes
+    enum ResolvedProperty
+    {
+        ResolvedRecycled = 0x1,
+        ResolvedSearchingEnabled = 0x2,
+        ResolvedAutoTypeEnabled = 0x4
+    };
+    struct ResolvedProperties
+    {
+        int valid = 0;
+        bool recycled = false;
+        const Group* recycleBin = nullptr;
+        bool searchingEnabled = true;
+        bool autoTypeEnabled = true;
+        QHash<QString, const Group*> customDataOwners;
+    };
+    mutable ResolvedProperties m_resolved;
+
     bool m_updateTimeinfo;
 
     friend Group* Database::setRootGroup(Group* group);
@@ -232,4 +257,90 @@ private:
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Group::CloneFlags)
 
+template <typename Visitor, typename T> inline bool Group::visit(Visitor& visitor, T item)
+{
+    if constexpr (std::is_void_v<decltype(visitor(item))>) {
+        visitor(item);
+        return true;
+    } else {
+        return visitor(item);
+    }
+}
+
+/**
+ * Visit the entries of this group and all of its subgroups depth-first, in the
+ * same order as entriesRecursive() but without building intermediate lists.
+ * The visitor may return false to stop early. The tree must not be modified
+ * during the traversal.
+ *
+ * @param visitor callable taking an Entry*, optionally returning bool
+ * @param includeHistoryItems also visit history items after the entries of each group
+ * @return false if the visitor stopped the traversal
+ */
+template <typename Visitor> bool Group::forEachEntryRecursive(Visitor&& visitor, bool includeHistoryItems) const
+{
+    for (Entry* entry : m_entries) {
+        if (!visit(visitor, entry)) {
+            return false;
+        }
+    }
+
+    if (includeHistoryItems) {
+        for (const Entry* entry : m_entries) {
+            for (Entry* historyItem : entry->historyItems()) {
+                if (!visit(visitor, historyItem)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    for (const Group* group : m_children) {
+        if (!group->forEachEntryRecursive(visitor, includeHistoryItems)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Visit this group and all of its subgroups depth-first, in the same order as
+ * groupsRecursive() but without building intermediate lists. The visitor may
+ * return false to stop early. The tree must not be modified during the traversal.
+ *
+ * @param visitor callable taking a group pointer, optionally returning bool
+ * @param includeSelf also visit this group
+ * @return false if the visitor stopped the traversal
+ */
+template <typename Visitor> bool Group::forEachGroupRecursive(Visitor&& visitor, bool includeSelf) const
+{
+    if (includeSelf && !visit(visitor, this)) {
+        return false;
+    }
+
+    for (const Group* group : m_children) {
+        if (!group->forEachGroupRecursive(visitor, true)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <typename Visitor> bool Group::forEachGroupRecursive(Visitor&& visitor, bool includeSelf)
+{
+    if (includeSelf && !visit(visitor, this)) {
+        return false;
+    }
+
+    for (Group* group : asConst(m_children)) {
+        if (!group->forEachGroupRecursive(visitor, true)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 #endif // KEEPASSX_GROUP_H
@@ -16,10 +16,20 @@
  */
 
 #include "HibpDownloader.h"
+#include "core/Config.h"
+#include "core/Global.h"
 #include "core/NetworkManager.h"
 
 #include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
 #include <QNetworkReply>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+
+#include <algorithm>
 
 namespace
 {
@@ -28,7 +38,7 @@ namespace
      *
      * The result is always exactly 40 characters long.
      */
-    QString sha1Hex(const QString& password)
+    QByteArray sha1Hex(const QString& password)
     {
         // Get the binary SHA1
         const auto sha1 = QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha1);
@@ -36,31 +46,94 @@ namespace
     }
 
     /*
-     * Search a password's hash in the output of the HIBP web service.
+     * Hash suffixes of a HIBP range response with their breach counts, sorted by suffix.
+     */
+    using SuffixTable = QVector<QPair<QByteArray, int>>;
+
+    SuffixTable parseRange(const QByteArray& range)
+    {
+        SuffixTable table;
+        for (const auto& line : range.split('\n')) {
+            // Every line has the format SUFFIX:COUNT
+            const auto separator = line.indexOf(':');
+            if (separator < 0) {
+                continue;
+            }
+            table.append({line.left(separator).trimmed().toUpper(), line.mid(separator + 1).trimmed().toInt()});
+        }
+        std::sort(table.begin(), table.end());
+        return table;
+    }
+
+    /*
+     * Search a password's hash in a parsed range response.
      *
      * Returns the number of times the password is found in breaches, or
      * 0 if the password is not in the HIBP result.
      */
-    int pwnCount(const QString& password, const QString& hibpResult)
+    int pwnCount(const QByteArray& hash, const SuffixTable& table)
     {
         // The first 5 characters of the hash are in the URL already,
         // the HIBP result contains the remainder
-        auto pos = hibpResult.indexOf(sha1Hex(password).mid(5));
-        if (pos < 0) {
+        const auto suffix = hash.mid(5);
+        const auto it = std::lower_bound(
+            table.constBegin(), table.constEnd(), suffix, [](const QPair<QByteArray, int>& item, const QByteArray& key) {
+                return item.first < key;
+            });
+        if (it == table.constEnd() || it->first != suffix) {
             return 0;
         }
+        return it->second;
+    }
+
+    /*
+     * Directory of the cached range responses of an endpoint.
+     */
+    QString cacheDir(const QString& rangeUrl)
+    {
+        const auto urlHash = QCryptographicHash::hash(rangeUrl.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+        return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/hibp/" + urlHash;
+    }
+
+    /*
+     * Load a cached range response, returns false if there is none or it has expired.
+     */
+    bool readCachedRange(const QString& rangeUrl, const QString& prefix, QByteArray& range)
+    {
+        const int ttl = config()->get(Config::HibpCacheTtl).toInt();
+        if (ttl <= 0) {
+            return false;
+        }
+
+        QFile file(cacheDir(rangeUrl) + "/" + prefix);
+        const auto modified = QFileInfo(file).lastModified();
+        if (!modified.isValid() || modified.secsTo(QDateTime::currentDateTime()) >= ttl) {
+            return false;
+        }
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
 
-        // Skip past the sha1 and ':'
-        pos += 36;
+        range = file.readAll();
+        return true;
+    }
+
+    void writeCachedRange(const QString& rangeUrl, const QString& prefix, const QByteArray& range)
+    {
+        if (config()->get(Config::HibpCacheTtl).toInt() <= 0) {
+            return;
+        }
 
-        // Find where the count ends
-        auto end = hibpResult.indexOf('\n', pos);
-        if (end < 0) {
-            end = hibpResult.size();
+        const auto dir = cacheDir(rangeUrl);
+        if (!QDir().mkpath(dir)) {
+            return;
         }
 
-        // Extract the count, remove remaining whitespace, and convert to int
-        return hibpResult.midRef(pos, end - pos).trimmed().toInt();
+        QSaveFile file(dir + "/" + prefix);
+        if (file.open(QIODevice::WriteOnly)) {
+            file.write(range);
+            file.commit();
+        }
     }
 } // namespace
 
@@ -92,27 +165,23 @@ void HibpDownloader::add(const QString& password)
  */
 void HibpDownloader::validate()
 {
-    for (auto password : m_pwdsToTry) {
-        // The URL we query is https://api.pwnedpasswords.com/range/XXXXX,
-        // where XXXXX is the first five bytes of the hex representation of
-        // the password's SHA1.
-        const auto url = QString("https://api.pwnedpasswords.com/range/") + sha1Hex(password).left(5);
+    m_rangeUrl = config()->get(Config::HibpRangeUrl).toString();
 
-        // HIBP requires clients to specify a user agent in the request
-        // (https://haveibeenpwned.com/API/v3#UserAgent); however, in order
-        // to minimize the amount of information we expose about ourselves,
-        // we don't add the KeePassXC version number or platform.
-        auto request = QNetworkRequest(url);
-        request.setRawHeader("User-Agent", "KeePassXC");
-
-        // Finally, submit the request to HIBP.
-        auto reply = getNetMgr()->get(request);
-        connect(reply, &QNetworkReply::finished, this, &HibpDownloader::fetchFinished);
-        connect(reply, &QIODevice::readyRead, this, &HibpDownloader::fetchReadyRead);
-        m_replies.insert(reply, {password, {}});
+    for (const auto& password : asConst(m_pwdsToTry)) {
+        // Passwords sharing the first five characters of the hex representation
+        // of their SHA1 are validated with the same range query
+        const auto prefix = QString::fromLatin1(sha1Hex(password).left(5));
+        // A prefix is fetched once, it stays pending until its range was processed
+        if (!m_pendingPwds.contains(prefix)) {
+            m_prefixesToFetch << prefix;
+        }
+        m_pendingPwds[prefix] << password;
     }
 
     m_pwdsToTry.clear();
+
+    // Results are always delivered asynchronously, even if they are cached
+    QTimer::singleShot(0, this, &HibpDownloader::fetchNext);
 }
 
 int HibpDownloader::passwordsToValidate() const
@@ -122,7 +191,11 @@ int HibpDownloader::passwordsToValidate() const
 
 int HibpDownloader::passwordsRemaining() const
 {
-    return m_replies.size();
+    int remaining = 0;
+    for (const auto& passwords : m_pendingPwds) {
+        remaining += passwords.size();
+    }
+    return remaining;
 }
 
 /*
@@ -130,11 +203,72 @@ int HibpDownloader::passwordsRemaining() const
  */
 void HibpDownloader::abort()
 {
-    for (auto reply : m_replies.keys()) {
+    // Forget the replies first, aborting them emits their finished signal
+    const auto replies = m_replies.keys();
+    m_replies.clear();
+    m_prefixesToFetch.clear();
+    m_pendingPwds.clear();
+
+    for (auto reply : replies) {
         reply->abort();
         reply->deleteLater();
     }
-    m_replies.clear();
+}
+
+/*
+ * Start range queries until the concurrency limit is reached,
+ * answering queries from the cache where possible.
+ */
+void HibpDownloader::fetchNext()
+{
+    const int maxRequests = qMax(1, config()->get(Config::HibpMaxConcurrentRequests).toInt());
+
+    while (!m_prefixesToFetch.isEmpty() && m_replies.size() < maxRequests) {
+        const auto prefix = m_prefixesToFetch.takeFirst();
+
+        QByteArray range;
+        if (readCachedRange(m_rangeUrl, prefix, range)) {
+            processRange(prefix, range);
+            continue;
+        }
+
+        // The URL we query is https://api.pwnedpasswords.com/range/XXXXX,
+        // where XXXXX is the first five bytes of the hex representation of
+        // the password's SHA1.
+        const auto url = m_rangeUrl + prefix;
+
+        // HIBP requires clients to specify a user agent in the request
+        // (https://haveibeenpwned.com/API/v3#UserAgent); however, in order
+        // to minimize the amount of information we expose about ourselves,
+        // we don't add the KeePassXC version number or platform.
+        auto request = QNetworkRequest(url);
+        request.setRawHeader("User-Agent", "KeePassXC");
+
+        // Finally, submit the request to HIBP.
+        auto reply = getNetMgr()->get(request);
+        connect(reply, &QNetworkReply::finished, this, &HibpDownloader::fetchFinished);
+        connect(reply, &QIODevice::readyRead, this, &HibpDownloader::fetchReadyRead);
+        m_replies.insert(reply, {prefix, {}});
+    }
+}
+
+/*
+ * Send the results of all passwords with the given hash prefix.
+ */
+void HibpDownloader::processRange(const QString& prefix, const QByteArray& range)
+{
+    const auto table = parseRange(range);
+
+    // Remove each password before its result is sent, so that
+    // passwordsRemaining() is up to date for the receivers
+    while (m_pendingPwds.contains(prefix)) {
+        auto& passwords = m_pendingPwds[prefix];
+        const auto password = passwords.takeFirst();
+        if (passwords.isEmpty()) {
+            m_pendingPwds.remove(prefix);
+        }
+        emit hibpResult(password, pwnCount(sha1Hex(password), table));
+    }
 }
 
 /*
@@ -164,7 +298,7 @@ void HibpDownloader::fetchFinished()
     const auto ok = reply->error() == QNetworkReply::NoError;
     const auto err = reply->errorString();
 
-    const auto password = entry->first;
+    const auto prefix = entry->first;
     const auto hibpReply = entry->second;
 
     reply->deleteLater();
@@ -182,6 +316,8 @@ void HibpDownloader::fetchFinished()
         return;
     }
 
-    // Current password validated, send the result to the caller
-    emit hibpResult(password, pwnCount(password, hibpReply));
+    // Passwords of the current prefix validated, send the results to the caller
+    writeCachedRange(m_rangeUrl, prefix, hibpReply);
+    processRange(prefix, hibpReply);
+    fetchNext();
 }
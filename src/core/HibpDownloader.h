@@ -36,6 +36,11 @@ class QNetworkReply;
  * Usage: Pass the password to check to the ctor and process
  * the `finished` signal to get the result. Process the
  * `failed` signal to handle errors.
+ *
+ * Passwords sharing a hash prefix are checked with a single range
+ * query, at most Config::HibpMaxConcurrentRequests queries run at
+ * once. Range responses are cached on disk for Config::HibpCacheTtl
+ * seconds.
  */
 class HibpDownloader : public QObject
 {
@@ -58,12 +63,18 @@ public slots:
     void abort();
 
 private slots:
+    void fetchNext();
     void fetchFinished();
     void fetchReadyRead();
 
 private:
+    void processRange(const QString& prefix, const QByteArray& range);
+
     QStringList m_pwdsToTry; // The list of remaining passwords to validate
+    QHash<QString, QStringList> m_pendingPwds; // Passwords being validated by hash prefix
+    QStringList m_prefixesToFetch; // Prefixes without a running range query
     QHash<QNetworkReply*, QPair<QString, QByteArray>> m_replies;
+    QString m_rangeUrl;
 };
 
 #endif // KEEPASSXC_HIBPDOWNLOADER_H
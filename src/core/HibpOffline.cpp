@@ -20,128 +20,469 @@
 #include "core/Group.h"
 
 #include <QCryptographicHash>
-#include <QProcess>
+#include <QFileDevice>
+#include <QtEndian>
+
+#include <climits>
+#include <cstring>
 
 namespace HibpOffline
 {
-    const std::size_t SHA1_BYTES = 20;
+    const int SHA1_HEX_CHARS = 40;
+
+    // Binary index layout (all integers little endian):
+    //   header:  magic (8 bytes), version (quint32), key size (quint32), record count (quint64)
+    //   fan-out: one quint64 per value of the first two SHA-1 bytes, holding the
+    //            cumulative record count up to and including that bucket
+    //   records: SHA-1 bytes [2, 2 + key size) followed by the count (quint32)
+    const char INDEX_MAGIC[] = "KPXCHIBP";
+    const int INDEX_MAGIC_SIZE = 8;
+    const quint32 INDEX_VERSION = 1;
+    const int INDEX_HEADER_SIZE = INDEX_MAGIC_SIZE + 4 + 4 + 8;
+    const int INDEX_FANOUT_BUCKETS = 1 << 16;
+    const int INDEX_FANOUT_SIZE = INDEX_FANOUT_BUCKETS * 8;
+    const int INDEX_PREFIX_BYTES = 2;
+    const int INDEX_KEY_BYTES = 8;
+    const int INDEX_RECORD_SIZE = INDEX_KEY_BYTES + 4;
 
     enum class ParseResult
     {
         Ok,
-        Eof,
-        Error
+        Error,
+        Unordered
     };
 
-    ParseResult parseHibpLine(QIODevice& input, QByteArray& sha1, int& count)
+    struct HibpLine
     {
-        QByteArray hexSha1(SHA1_BYTES * 2, '\0');
-        const qint64 rc = input.read(hexSha1.data(), hexSha1.size());
-        if (rc == 0) {
-            return ParseResult::Eof;
-        } else if (rc != hexSha1.size()) {
-            return ParseResult::Error;
-        }
+        const char* sha1Hex;
+        int count;
+        qint64 end;
+    };
 
-        sha1 = QByteArray::fromHex(hexSha1);
+    inline char hexToUpper(char c)
+    {
+        return ('a' <= c && c <= 'f') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
 
-        char c;
-        if (!input.getChar(&c) || c != ':') {
+    inline bool isHex(char c)
+    {
+        return ('0' <= c && c <= '9') || ('A' <= c && c <= 'F') || ('a' <= c && c <= 'f');
+    }
+
+    /**
+     * Parse the line starting at offset pos; on success, line.end points
+     * past the line terminator(s) of the line.
+     */
+    ParseResult parseHibpLine(const char* data, qint64 size, qint64 pos, HibpLine& line)
+    {
+        if (size - pos < SHA1_HEX_CHARS + 2) {
             return ParseResult::Error;
         }
 
-        count = 0;
-        while (true) {
-            if (!input.getChar(&c)) {
+        line.sha1Hex = data + pos;
+        for (int i = 0; i < SHA1_HEX_CHARS; ++i) {
+            if (!isHex(line.sha1Hex[i])) {
                 return ParseResult::Error;
             }
+        }
 
-            if (c == '\n' || c == '\r') {
-                break;
-            }
+        pos += SHA1_HEX_CHARS;
+        if (data[pos++] != ':') {
+            return ParseResult::Error;
+        }
 
+        const qint64 digitsStart = pos;
+        line.count = 0;
+        for (; pos < size && data[pos] != '\n' && data[pos] != '\r'; ++pos) {
+            const char c = data[pos];
             if (!('0' <= c && c <= '9')) {
                 return ParseResult::Error;
             }
 
-            count *= 10;
-            count += (c - '0');
+            // Saturate like the index, a malformed count must not overflow
+            const int digit = c - '0';
+            line.count = line.count > (INT_MAX - digit) / 10 ? INT_MAX : line.count * 10 + digit;
         }
 
-        while (1 == input.peek(&c, 1) && (c == '\n' || c == '\r')) {
-            input.getChar(&c);
+        if (pos == digitsStart) {
+            return ParseResult::Error;
         }
 
+        while (pos < size && (data[pos] == '\n' || data[pos] == '\r')) {
+            ++pos;
+        }
+
+        line.end = pos;
         return ParseResult::Ok;
     }
 
-    bool
-    report(QSharedPointer<Database> db, QIODevice& hibpInput, QList<QPair<const Entry*, int>>& findings, QString* error)
+    int compareSha1Hex(const char* lineHex, const QByteArray& upperHex)
+    {
+        for (int i = 0; i < SHA1_HEX_CHARS; ++i) {
+            const char c = hexToUpper(lineHex[i]);
+            if (c != upperHex[i]) {
+                return c < upperHex[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    int compareSha1Hex(const char* lhsHex, const char* rhsHex)
     {
-        QMultiHash<QByteArray, const Entry*> entriesBySha1;
-        for (const auto* entry : db->rootGroup()->entriesRecursive()) {
-            if (!entry->isRecycled()) {
-                const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
-                entriesBySha1.insert(sha1, entry);
+        for (int i = 0; i < SHA1_HEX_CHARS; ++i) {
+            const char lhs = hexToUpper(lhsHex[i]);
+            const char rhs = hexToUpper(rhsHex[i]);
+            if (lhs != rhs) {
+                return lhs < rhs ? -1 : 1;
             }
         }
+        return 0;
+    }
 
-        QByteArray sha1;
-        for (quint64 lineNum = 1;; ++lineNum) {
-            int count = 0;
+    /**
+     * Start offset of the last line, ignoring trailing line terminators
+     */
+    qint64 lastLineStart(const char* data, qint64 size)
+    {
+        qint64 pos = size;
+        while (pos > 0 && (data[pos - 1] == '\n' || data[pos - 1] == '\r')) {
+            --pos;
+        }
+        while (pos > 0 && data[pos - 1] != '\n' && data[pos - 1] != '\r') {
+            --pos;
+        }
+        return pos;
+    }
 
-            switch (parseHibpLine(hibpInput, sha1, count)) {
-            case ParseResult::Eof:
-                return true;
-            case ParseResult::Error:
-                *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
-                return false;
-            default:
+    /**
+     * Binary search of a sorted HIBP file. The search range always starts
+     * at a line boundary; the probe at the middle of the range is moved back
+     * to the start of its line, so only O(log n) lines are ever touched.
+     * Every probed hash has to lie between the lines bounding the range,
+     * otherwise the file is not sorted and the search can't be trusted.
+     */
+    ParseResult
+    findSha1(const char* data, qint64 size, const QByteArray& upperHex, int& count, qint64& errorOffset)
+    {
+        qint64 lo = 0;
+        qint64 hi = size;
+        const char* loHex = nullptr;
+        const char* hiHex = nullptr;
+        count = -1;
+
+        while (lo < hi) {
+            const qint64 mid = lo + (hi - lo) / 2;
+            qint64 lineStart = mid;
+            // A probe on the terminator of a line (e.g. the '\n' of "\r\n") belongs to that line
+            while (lineStart > lo && (data[lineStart] == '\n' || data[lineStart] == '\r')) {
+                --lineStart;
+            }
+            while (lineStart > lo && data[lineStart - 1] != '\n' && data[lineStart - 1] != '\r') {
+                --lineStart;
+            }
+
+            HibpLine line;
+            if (parseHibpLine(data, hi, lineStart, line) != ParseResult::Ok) {
+                errorOffset = lineStart;
+                return ParseResult::Error;
+            }
+
+            if ((loHex && compareSha1Hex(line.sha1Hex, loHex) < 0)
+                || (hiHex && compareSha1Hex(line.sha1Hex, hiHex) > 0)) {
+                errorOffset = lineStart;
+                return ParseResult::Unordered;
+            }
+
+            const int cmp = compareSha1Hex(line.sha1Hex, upperHex);
+            if (cmp == 0) {
+                count = line.count;
                 break;
+            } else if (cmp < 0) {
+                lo = line.end;
+                loHex = line.sha1Hex;
+            } else {
+                hi = lineStart;
+                hiHex = line.sha1Hex;
             }
+        }
+
+        return ParseResult::Ok;
+    }
 
-            for (const auto* entry : entriesBySha1.values(sha1)) {
-                findings.append({entry, count});
+    /**
+     * Read-only view of a whole HIBP input. File devices are memory-mapped,
+     * other devices are read into memory.
+     */
+    class InputView
+    {
+    public:
+        ~InputView()
+        {
+            if (m_mapped) {
+                m_file->unmap(m_mapped);
             }
         }
+
+        bool open(QIODevice& device, QString* error)
+        {
+            if (!device.isReadable()) {
+                *error = QObject::tr("HIBP file could not be read: %1").arg(device.errorString());
+                return false;
+            }
+
+            m_file = qobject_cast<QFileDevice*>(&device);
+            if (m_file) {
+                size = m_file->size();
+                if (size > 0) {
+                    m_mapped = m_file->map(0, size);
+                    if (!m_mapped) {
+                        *error = QObject::tr("Failed to map HIBP file into memory: %1").arg(m_file->errorString());
+                        return false;
+                    }
+                    data = reinterpret_cast<const char*>(m_mapped);
+                }
+            } else {
+                m_contents = device.readAll();
+                data = m_contents.constData();
+                size = m_contents.size();
+            }
+            return true;
+        }
+
+        const char* data = nullptr;
+        qint64 size = 0;
+
+    private:
+        QFileDevice* m_file = nullptr;
+        uchar* m_mapped = nullptr;
+        QByteArray m_contents;
+    };
+
+    inline quint64 readUInt64(const char* p)
+    {
+        return qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(p));
+    }
+
+    inline quint32 readUInt32(const char* p)
+    {
+        return qFromLittleEndian<quint32>(reinterpret_cast<const uchar*>(p));
+    }
+
+    bool isIndex(const InputView& input)
+    {
+        return input.size >= INDEX_MAGIC_SIZE && memcmp(input.data, INDEX_MAGIC, INDEX_MAGIC_SIZE) == 0;
     }
 
-    bool okonReport(QSharedPointer<Database> db,
-                    const QString& okon,
-                    const QString& okonDatabase,
-                    QList<QPair<const Entry*, int>>& findings,
-                    QString* error)
+    bool checkIndexHeader(const InputView& input, QString* error)
     {
-        if (!okonDatabase.endsWith(".okon")) {
-            *error = QObject::tr("To use okon, you must provide a post-processed file (e.g. file.okon)");
+        const qint64 payloadSize = input.size - INDEX_HEADER_SIZE - INDEX_FANOUT_SIZE;
+        if (payloadSize < 0 || readUInt32(input.data + INDEX_MAGIC_SIZE) != INDEX_VERSION
+            || readUInt32(input.data + INDEX_MAGIC_SIZE + 4) != INDEX_KEY_BYTES
+            || readUInt64(input.data + INDEX_MAGIC_SIZE + 8) != static_cast<quint64>(payloadSize / INDEX_RECORD_SIZE)
+            || payloadSize % INDEX_RECORD_SIZE != 0) {
+            *error = QObject::tr("HIBP index file is corrupted or has an unsupported version");
             return false;
         }
+        return true;
+    }
 
-        QProcess okonProcess;
+    /**
+     * Index lookup: the fan-out table gives the bucket for the first two
+     * SHA-1 bytes directly, the (small) bucket is then binary searched.
+     */
+    ParseResult findSha1InIndex(const InputView& input, const QByteArray& sha1, int& count)
+    {
+        const auto recordCount = readUInt64(input.data + INDEX_MAGIC_SIZE + 8);
+        const char* fanout = input.data + INDEX_HEADER_SIZE;
+        const char* records = fanout + INDEX_FANOUT_SIZE;
+        const char* key = sha1.constData() + INDEX_PREFIX_BYTES;
 
-        for (const auto* entry : db->rootGroup()->entriesRecursive()) {
-            if (!entry->isRecycled()) {
-                const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
-                okonProcess.start(okon, {"--path", okonDatabase, "--hash", QString::fromLatin1(sha1.toHex())});
-                if (!okonProcess.waitForStarted()) {
-                    *error = QObject::tr("Could not start okon process: %1").arg(okon);
+        const int bucket = (static_cast<uchar>(sha1[0]) << 8) | static_cast<uchar>(sha1[1]);
+        quint64 lo = bucket > 0 ? readUInt64(fanout + (bucket - 1) * 8) : 0;
+        quint64 hi = readUInt64(fanout + bucket * 8);
+        if (lo > hi || hi > recordCount) {
+            return ParseResult::Error;
+        }
+
+        count = -1;
+        while (lo < hi) {
+            const quint64 mid = lo + (hi - lo) / 2;
+            const char* record = records + mid * INDEX_RECORD_SIZE;
+            const int cmp = memcmp(record, key, INDEX_KEY_BYTES);
+            if (cmp == 0) {
+                count = static_cast<int>(qMin<quint32>(readUInt32(record + INDEX_KEY_BYTES), INT_MAX));
+                break;
+            } else if (cmp < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        return ParseResult::Ok;
+    }
+
+    bool
+    report(QSharedPointer<Database> db, QIODevice& hibpInput, QList<QPair<const Entry*, int>>& findings, QString* error)
+    {
+        InputView input;
+        if (!input.open(hibpInput, error)) {
+            return false;
+        }
+
+        const bool index = isIndex(input);
+        if (index) {
+            if (!checkIndexHeader(input, error)) {
+                return false;
+            }
+        } else {
+            // A binary search only touches a few lines, so check the first and the
+            // last one up front to reject files that are not in HIBP format at all
+            // or not ordered by hash (e.g. ordered by prevalence).
+            if (input.size > 0) {
+                const qint64 lastStart = lastLineStart(input.data, input.size);
+                HibpLine firstLine;
+                HibpLine lastLine;
+                if (parseHibpLine(input.data, input.size, 0, firstLine) != ParseResult::Ok) {
+                    *error = QObject::tr("HIBP file, offset %1: parse error").arg(0);
+                    return false;
+                }
+                if (parseHibpLine(input.data, input.size, lastStart, lastLine) != ParseResult::Ok) {
+                    *error = QObject::tr("HIBP file, offset %1: parse error").arg(lastStart);
+                    return false;
+                }
+                if (compareSha1Hex(firstLine.sha1Hex, lastLine.sha1Hex) > 0) {
+                    *error = QObject::tr("HIBP file, offset %1: file is not ordered by hash").arg(lastStart);
                     return false;
                 }
+            }
+        }
+
+        QHash<QByteArray, int> countsBySha1;
+        return db->rootGroup()->forEachEntryRecursive([&](const Entry* entry) {
+            if (entry->isRecycled()) {
+                return true;
+            }
+
+            const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
+            auto it = countsBySha1.constFind(sha1);
+            if (it == countsBySha1.constEnd()) {
+                int count = -1;
+                if (index) {
+                    if (findSha1InIndex(input, sha1, count) != ParseResult::Ok) {
+                        *error = QObject::tr("HIBP index file is corrupted or has an unsupported version");
+                        return false;
+                    }
+                } else {
+                    qint64 errorOffset = 0;
+                    const auto result = findSha1(input.data, input.size, sha1.toHex().toUpper(), count, errorOffset);
+                    if (result == ParseResult::Unordered) {
+                        *error = QObject::tr("HIBP file, offset %1: file is not ordered by hash").arg(errorOffset);
+                        return false;
+                    } else if (result != ParseResult::Ok) {
+                        *error = QObject::tr("HIBP file, offset %1: parse error").arg(errorOffset);
+                        return false;
+                    }
+                }
+                it = countsBySha1.insert(sha1, count);
+            }
 
-                if (!okonProcess.waitForFinished()) {
-                    *error = QObject::tr("Error: okon process did not finish");
+            if (it.value() >= 0) {
+                findings.append({entry, it.value()});
+            }
+            return true;
+        });
+    }
+
+    bool buildIndex(QIODevice& hibpInput, QIODevice& indexOutput, QString* error)
+    {
+        InputView input;
+        if (!input.open(hibpInput, error)) {
+            return false;
+        }
+
+        if (isIndex(input)) {
+            *error = QObject::tr("HIBP file is already an index");
+            return false;
+        }
+
+        QByteArray header(INDEX_HEADER_SIZE + INDEX_FANOUT_SIZE, '\0');
+        if (indexOutput.write(header) != header.size()) {
+            *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
+            return false;
+        }
+
+        QVector<quint64> bucketSizes(INDEX_FANOUT_BUCKETS, 0);
+        quint64 recordCount = 0;
+
+        QByteArray records;
+        records.reserve(1024 * 1024);
+        char sha1[SHA1_HEX_CHARS / 2];
+        char lastSha1[SHA1_HEX_CHARS / 2];
+
+        for (qint64 pos = 0; pos < input.size;) {
+            HibpLine line;
+            if (parseHibpLine(input.data, input.size, pos, line) != ParseResult::Ok) {
+                *error = QObject::tr("HIBP file, offset %1: parse error").arg(pos);
+                return false;
+            }
+
+            const QByteArray sha1Hex = QByteArray::fromRawData(line.sha1Hex, SHA1_HEX_CHARS);
+            const QByteArray sha1Bytes = QByteArray::fromHex(sha1Hex);
+            memcpy(sha1, sha1Bytes.constData(), sizeof(sha1));
+
+            if (recordCount > 0) {
+                const int cmp = memcmp(sha1, lastSha1, sizeof(sha1));
+                if (cmp < 0) {
+                    *error = QObject::tr("HIBP file, offset %1: file is not ordered by hash").arg(pos);
                     return false;
                 }
+                // Identical truncated keys cannot be told apart, keep the first one
+                if (memcmp(sha1, lastSha1, INDEX_PREFIX_BYTES + INDEX_KEY_BYTES) == 0) {
+                    pos = line.end;
+                    continue;
+                }
+            }
+            memcpy(lastSha1, sha1, sizeof(sha1));
+
+            uchar count[4];
+            qToLittleEndian<quint32>(static_cast<quint32>(line.count), count);
+            records.append(sha1 + INDEX_PREFIX_BYTES, INDEX_KEY_BYTES);
+            records.append(reinterpret_cast<const char*>(count), sizeof(count));
 
-                switch (okonProcess.exitCode()) {
-                case 1:
-                    findings.append({entry, -1});
-                    break;
-                case 2:
-                    *error = QObject::tr("Failed to load okon processed database: %1").arg(okonDatabase);
+            ++bucketSizes[(static_cast<uchar>(sha1[0]) << 8) | static_cast<uchar>(sha1[1])];
+            ++recordCount;
+
+            if (records.size() >= 1024 * 1024) {
+                if (indexOutput.write(records) != records.size()) {
+                    *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
                     return false;
                 }
+                records.resize(0);
             }
+
+            pos = line.end;
+        }
+
+        if (indexOutput.write(records) != records.size()) {
+            *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
+            return false;
+        }
+
+        auto headerData = reinterpret_cast<uchar*>(header.data());
+        memcpy(headerData, INDEX_MAGIC, INDEX_MAGIC_SIZE);
+        qToLittleEndian<quint32>(INDEX_VERSION, headerData + INDEX_MAGIC_SIZE);
+        qToLittleEndian<quint32>(INDEX_KEY_BYTES, headerData + INDEX_MAGIC_SIZE + 4);
+        qToLittleEndian<quint64>(recordCount, headerData + INDEX_MAGIC_SIZE + 8);
+        quint64 cumulative = 0;
+        for (int bucket = 0; bucket < INDEX_FANOUT_BUCKETS; ++bucket) {
+            cumulative += bucketSizes[bucket];
+            qToLittleEndian<quint64>(cumulative, headerData + INDEX_HEADER_SIZE + bucket * 8);
+        }
+
+        if (!indexOutput.seek(0) || indexOutput.write(header) != header.size()) {
+            *error = QObject::tr("Failed to write HIBP index: %1").arg(indexOutput.errorString());
+            return false;
         }
 
         return true;
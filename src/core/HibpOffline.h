@@ -27,16 +27,25 @@ class Entry;
 
 namespace HibpOffline
 {
+    /**
+     * Look up the passwords of all non-recycled entries in a HIBP SHA-1 file.
+     *
+     * The input is either the "ordered by hash" text download, where each
+     * lookup is a binary search over its lines, or an index created with
+     * buildIndex(). File devices are memory-mapped, other devices are read
+     * into memory first.
+     */
     bool report(QSharedPointer<Database> db,
                 QIODevice& hibpInput,
                 QList<QPair<const Entry*, int>>& findings,
                 QString* error);
 
-    bool okonReport(QSharedPointer<Database> db,
-                    const QString& okon,
-                    const QString& okonDatabase,
-                    QList<QPair<const Entry*, int>>& findings,
-                    QString* error);
+    /**
+     * Convert an "ordered by hash" HIBP text file into a compact binary index
+     * of truncated SHA-1 hashes and counts, which report() detects and queries
+     * with a fan-out table. indexOutput must be seekable.
+     */
+    bool buildIndex(QIODevice& hibpInput, QIODevice& indexOutput, QString* error);
 } // namespace HibpOffline
 
 #endif // KEEPASSXC_HIBPOFFLINE_H
@@ -67,9 +67,11 @@ QStringList Merger::merge()
     // Order of merge steps is important - it is possible that we
     // create some items before deleting them afterwards
     ChangeList changes;
-    changes << mergeGroup(m_context);
+    emit m_context.m_targetDb->aboutToMerge();
+    mergeGroup(m_context, changes);
     changes << mergeDeletions(m_context);
     changes << mergeMetadata(m_context);
+    emit m_context.m_targetDb->merged();
 
     // At this point we have a list of changes we may want to show the user
     if (!changes.isEmpty()) {
@@ -78,9 +80,10 @@ QStringList Merger::merge()
     return changes;
 }
 
-Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
+void Merger::mergeGroup(const MergeContext& context, ChangeList& changes)
 {
-    ChangeList changes;
+    // Lookups go through the UUID index of the target database, which stays
+    // current while entries and groups are created, moved and replaced below.
     // merge entries
     const QList<Entry*> sourceEntries = context.m_sourceGroup->entries();
     for (Entry* sourceEntry : sourceEntries) {
@@ -131,9 +134,8 @@ Merger::ChangeList Merger::mergeGroup(const MergeContext& context)
                                 context.m_targetRootGroup,
                                 sourceChildGroup,
                                 targetChildGroup};
-        changes << mergeGroup(subcontext);
+        mergeGroup(subcontext, changes);
     }
-    return changes;
 }
 
 Merger::ChangeList
@@ -226,6 +228,12 @@ void Merger::eraseEntry(Entry* entry)
     Database* database = entry->database();
     // most simple method to remove an item from DeletedObjects :(
     const QList<DeletedObject> deletions = database->deletedObjects();
+    deleteEntry(entry);
+    database->setDeletedObjects(deletions);
+}
+
+void Merger::deleteEntry(Entry* entry)
+{
     Group* parentGroup = entry->group();
     const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
     if (parentGroup) {
@@ -235,7 +243,6 @@ void Merger::eraseEntry(Entry* entry)
     if (parentGroup) {
         parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
     }
-    database->setDeletedObjects(deletions);
 }
 
 void Merger::eraseGroup(Group* group)
@@ -243,6 +250,12 @@ void Merger::eraseGroup(Group* group)
     Database* database = group->database();
     // most simple method to remove an item from DeletedObjects :(
     const QList<DeletedObject> deletions = database->deletedObjects();
+    deleteGroup(group);
+    database->setDeletedObjects(deletions);
+}
+
+void Merger::deleteGroup(Group* group)
+{
     Group* parentGroup = group->parentGroup();
     const bool groupUpdateTimeInfo = parentGroup ? parentGroup->canUpdateTimeinfo() : false;
     if (parentGroup) {
@@ -252,7 +265,6 @@ void Merger::eraseGroup(Group* group)
     if (parentGroup) {
         parentGroup->setUpdateTimeinfo(groupUpdateTimeInfo);
     }
-    database->setDeletedObjects(deletions);
 }
 
 Merger::ChangeList Merger::resolveEntryConflict_MergeHistories(const MergeContext& context,
@@ -317,6 +329,54 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
     const bool preferLocal = comparison < 0;
     const bool preferRemote = comparison > 0;
 
+    const QDateTime targetModificationTime = Clock::serialized(targetEntry->timeInfo().lastModificationTime());
+    const QDateTime sourceModificationTime = Clock::serialized(sourceEntry->timeInfo().lastModificationTime());
+
+    // Fast path for the common case of an unchanged entry: with equal modification times and a strictly
+    // ordered target history that already contains every source history item, the merged history would
+    // be identical to the target history, so skip cloning both histories only to throw the result away.
+    if (comparison == 0) {
+        QHash<QDateTime, const Entry*> targetHistoryByTime;
+        QDateTime previousTime;
+        bool ordered = true;
+        for (const Entry* historyItem : targetHistoryItems) {
+            const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
+            if (!targetHistoryByTime.isEmpty() && modificationTime <= previousTime) {
+                ordered = false;
+                break;
+            }
+            targetHistoryByTime.insert(modificationTime, historyItem);
+            previousTime = modificationTime;
+        }
+
+        bool covered = ordered;
+        for (int i = 0; covered && i < sourceHistoryItems.size(); ++i) {
+            covered = targetHistoryByTime.contains(
+                Clock::serialized(sourceHistoryItems.at(i)->timeInfo().lastModificationTime()));
+        }
+
+        if (covered) {
+            for (const Entry* historyItem : sourceHistoryItems) {
+                const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
+                if (!targetHistoryByTime.value(modificationTime)->equals(historyItem, CompareItemIgnoreMilliseconds)) {
+                    ::qWarning("History entry of %s[%s] at %s contains conflicting changes - conflict resolution may "
+                               "lose data!",
+                               qPrintable(sourceEntry->title()),
+                               qPrintable(sourceEntry->uuidToHex()),
+                               qPrintable(modificationTime.toString("yyyy-MM-dd HH-mm-ss-zzz")));
+                }
+            }
+            if (!targetEntry->equals(sourceEntry,
+                                     CompareItemIgnoreMilliseconds | CompareItemIgnoreHistory
+                                         | CompareItemIgnoreLocation)) {
+                ::qWarning("Entry of %s[%s] contains conflicting changes - conflict resolution may lose data!",
+                           qPrintable(sourceEntry->title()),
+                           qPrintable(sourceEntry->uuidToHex()));
+            }
+            return false;
+        }
+    }
+
     QMap<QDateTime, Entry*> merged;
     for (Entry* historyItem : targetHistoryItems) {
         const QDateTime modificationTime = Clock::serialized(historyItem->timeInfo().lastModificationTime());
@@ -350,8 +410,6 @@ bool Merger::mergeHistory(const Entry* sourceEntry,
         }
     }
 
-    const QDateTime targetModificationTime = Clock::serialized(targetEntry->timeInfo().lastModificationTime());
-    const QDateTime sourceModificationTime = Clock::serialized(sourceEntry->timeInfo().lastModificationTime());
     if (targetModificationTime == sourceModificationTime
         && !targetEntry->equals(sourceEntry,
                                 CompareItemIgnoreMilliseconds | CompareItemIgnoreHistory | CompareItemIgnoreLocation)) {
@@ -454,8 +512,11 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
         }
     }
 
-    while (!entries.isEmpty()) {
-        auto* entry = entries.takeFirst();
+    // Erased items are recorded in DeletedObjects as a side effect; restore the
+    // list once below instead of after every single erase
+    const QList<DeletedObject> targetDeletedObjects = context.m_targetDb->deletedObjects();
+
+    for (auto* entry : asConst(entries)) {
         const auto& object = mergedDeletions[entry->uuid()];
         if (entry->timeInfo().lastModificationTime() > object.deletionTime) {
             // keep deleted entry since it was changed after deletion date
@@ -468,22 +529,36 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
             changes << tr("Deleting orphan %1 [%2]").arg(entry->title(), entry->uuidToHex());
         }
         // Entry is inserted into deletedObjects after deletions are processed
-        eraseEntry(entry);
+        deleteEntry(entry);
+    }
+
+    // Number of children of each group that are still waiting in the queue
+    QSet<Group*> queuedGroups = groups.toSet();
+    QHash<Group*, int> pendingChildren;
+    for (auto* group : asConst(groups)) {
+        if (queuedGroups.contains(group->parentGroup())) {
+            ++pendingChildren[group->parentGroup()];
+        }
     }
 
     while (!groups.isEmpty()) {
         auto* group = groups.takeFirst();
-        if (!(group->children().toSet() & groups.toSet()).isEmpty()) {
+        if (pendingChildren.value(group) > 0) {
             // we need to finish all children before we are able to determine if the group can be removed
             groups << group;
             continue;
         }
+        queuedGroups.remove(group);
+        if (queuedGroups.contains(group->parentGroup())) {
+            --pendingChildren[group->parentGroup()];
+        }
+
         const auto& object = mergedDeletions[group->uuid()];
         if (group->timeInfo().lastModificationTime() > object.deletionTime) {
             // keep deleted group since it was changed after deletion date
             continue;
         }
-        if (!group->entriesRecursive(false).isEmpty() || !group->groupsRecursive(false).isEmpty()) {
+        if (!group->entries().isEmpty() || !group->children().isEmpty()) {
             // keep deleted group since it contains undeleted content
             continue;
         }
@@ -493,8 +568,10 @@ Merger::ChangeList Merger::mergeDeletions(const MergeContext& context)
         } else {
             changes << tr("Deleting orphan %1 [%2]").arg(group->name(), group->uuidToHex());
         }
-        eraseGroup(group);
+        deleteGroup(group);
     }
+    context.m_targetDb->setDeletedObjects(targetDeletedObjects);
+
     // Put every deletion to the earliest date of deletion
     if (deletions != context.m_targetDb->deletedObjects()) {
         changes << tr("Changed deleted objects");
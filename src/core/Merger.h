@@ -47,7 +47,7 @@ private:
         QPointer<const Group> m_sourceGroup;
         QPointer<Group> m_targetGroup;
     };
-    ChangeList mergeGroup(const MergeContext& context);
+    void mergeGroup(const MergeContext& context, ChangeList& changes);
     ChangeList mergeDeletions(const MergeContext& context);
     ChangeList mergeMetadata(const MergeContext& context);
     bool mergeHistory(const Entry* sourceEntry, Entry* targetEntry, Group::MergeMode mergeMethod, const int maxItems);
@@ -57,6 +57,10 @@ private:
     void eraseEntry(Entry* entry);
     // remove an entry without a trace in the deletedObjects - needed for elemination cloned entries
     void eraseGroup(Group* group);
+    // remove an entry without touching the timeinfo of its group - the caller restores deletedObjects
+    void deleteEntry(Entry* entry);
+    // remove a group without touching the timeinfo of its parent - the caller restores deletedObjects
+    void deleteGroup(Group* group);
     ChangeList resolveEntryConflict(const MergeContext& context, const Entry* existingEntry, Entry* otherEntry);
     ChangeList resolveGroupConflict(const MergeContext& context, const Group* existingGroup, Group* otherGroup);
     Merger::ChangeList resolveEntryConflict_MergeHistories(const MergeContext& context,
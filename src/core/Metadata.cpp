@@ -384,6 +384,7 @@ void Metadata::addCustomIcon(const QUuid& uuid, const CustomIconData& iconData)
     m_customIconsHashes[hash] = uuid;
     Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
 
+    emit customIconAdded(uuid);
     emitModified();
 }
 
@@ -410,6 +411,7 @@ void Metadata::removeCustomIcon(const QUuid& uuid)
     m_customIconsOrder.removeAll(uuid);
     Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
     dynamic_cast<Database*>(parent())->addDeletedObject(uuid);
+    emit customIconRemoved(uuid);
     emitModified();
 }
 
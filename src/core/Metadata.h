@@ -167,6 +167,10 @@ public:
      */
     void copyAttributesFrom(const Metadata* other);
 
+signals:
+    void customIconAdded(const QUuid& uuid);
+    void customIconRemoved(const QUuid& uuid);
+
 private:
     template <class P, class V> bool set(P& property, const V& value);
     template <class P, class V> bool set(P& property, const V& value, QDateTime& dateTime);
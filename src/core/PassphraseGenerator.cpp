@@ -110,37 +110,57 @@ void PassphraseGenerator::setWordSeparator(const QString& separator)
 }
 
 QString PassphraseGenerator::generatePassphrase() const
+{
+    return generatePassphrases(1).first();
+}
+
+/**
+ * Generate @p count passphrases with the same settings, taking
+ * random numbers from the buffered generator.
+ */
+QStringList PassphraseGenerator::generatePassphrases(int count) const
 {
     QString tmpWord;
     Q_ASSERT(isValid());
 
+    QStringList passphrases;
+    passphrases.reserve(count);
+
     // In case there was an error loading the wordlist
     if (m_wordlist.length() == 0) {
-        return {};
+        for (int i = 0; i < count; ++i) {
+            passphrases.append({});
+        }
+        return passphrases;
     }
 
-    QStringList words;
-    for (int i = 0; i < m_wordCount; ++i) {
-        int wordIndex = randomGen()->randomUInt(static_cast<quint32>(m_wordlist.length()));
-        tmpWord = m_wordlist.at(wordIndex);
-
-        // convert case
-        switch (m_wordCase) {
-        case UPPERCASE:
-            tmpWord = tmpWord.toUpper();
-            break;
-        case TITLECASE:
-            tmpWord = tmpWord.replace(0, 1, tmpWord.left(1).toUpper());
-            break;
-        case LOWERCASE:
-        default:
-            tmpWord = tmpWord.toLower();
-            break;
+    auto random = randomGen(Random::BufferedDrbg);
+
+    for (int n = 0; n < count; ++n) {
+        QStringList words;
+        for (int i = 0; i < m_wordCount; ++i) {
+            int wordIndex = random->randomUInt(static_cast<quint32>(m_wordlist.length()));
+            tmpWord = m_wordlist.at(wordIndex);
+
+            // convert case
+            switch (m_wordCase) {
+            case UPPERCASE:
+                tmpWord = tmpWord.toUpper();
+                break;
+            case TITLECASE:
+                tmpWord = tmpWord.replace(0, 1, tmpWord.left(1).toUpper());
+                break;
+            case LOWERCASE:
+            default:
+                tmpWord = tmpWord.toLower();
+                break;
+            }
+            words.append(tmpWord);
         }
-        words.append(tmpWord);
+        passphrases.append(words.join(m_separator));
     }
 
-    return words.join(m_separator);
+    return passphrases;
 }
 
 bool PassphraseGenerator::isValid() const
@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_PASSPHRASEGENERATOR_H
 #define KEEPASSX_PASSPHRASEGENERATOR_H
 
+#include <QStringList>
 #include <QVector>
 
 class PassphraseGenerator
@@ -42,6 +43,7 @@ public:
     bool isValid() const;
 
     QString generatePassphrase() const;
+    QStringList generatePassphrases(int count) const;
 
     static constexpr int DefaultWordCount = 7;
     static const char* DefaultSeparator;
@@ -58,6 +58,15 @@ void PasswordGenerator::setFlags(const GeneratorFlags& flags)
 }
 
 QString PasswordGenerator::generatePassword() const
+{
+    return generatePasswords(1).first();
+}
+
+/**
+ * Generate @p count passwords with the same settings. The character groups
+ * are only built once and random numbers come from the buffered generator.
+ */
+QStringList PasswordGenerator::generatePasswords(int count) const
 {
     Q_ASSERT(isValid());
 
@@ -70,24 +79,38 @@ QString PasswordGenerator::generatePassword() const
         }
     }
 
+    QStringList passwords;
+    passwords.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        passwords.append(generatePassword(groups, passwordChars));
+    }
+    return passwords;
+}
+
+QString PasswordGenerator::generatePassword(const QVector<PasswordGroup>& groups,
+                                            const QVector<QChar>& passwordChars) const
+{
+    auto random = randomGen(Random::BufferedDrbg);
+
     QString password;
+    password.reserve(m_length);
 
     if (m_flags & CharFromEveryGroup) {
         for (const auto& group : groups) {
-            int pos = randomGen()->randomUInt(static_cast<quint32>(group.size()));
+            int pos = random->randomUInt(static_cast<quint32>(group.size()));
 
             password.append(group[pos]);
         }
 
         for (int i = groups.size(); i < m_length; i++) {
-            int pos = randomGen()->randomUInt(static_cast<quint32>(passwordChars.size()));
+            int pos = random->randomUInt(static_cast<quint32>(passwordChars.size()));
 
             password.append(passwordChars[pos]);
         }
 
         // shuffle chars
         for (int i = (password.size() - 1); i >= 1; i--) {
-            int j = randomGen()->randomUInt(static_cast<quint32>(i + 1));
+            int j = random->randomUInt(static_cast<quint32>(i + 1));
 
             QChar tmp = password[i];
             password[i] = password[j];
@@ -95,7 +118,7 @@ QString PasswordGenerator::generatePassword() const
         }
     } else {
         for (int i = 0; i < m_length; i++) {
-            int pos = randomGen()->randomUInt(static_cast<quint32>(passwordChars.size()));
+            int pos = random->randomUInt(static_cast<quint32>(passwordChars.size()));
 
             password.append(passwordChars[pos]);
         }
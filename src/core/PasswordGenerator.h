@@ -20,6 +20,7 @@
 #define KEEPASSX_PASSWORDGENERATOR_H
 
 #include <QObject>
+#include <QStringList>
 #include <QVector>
 
 typedef QVector<QChar> PasswordGroup;
@@ -75,6 +76,7 @@ public:
     const QString& getExcludedCharacterSet() const;
 
     QString generatePassword() const;
+    QStringList generatePasswords(int count) const;
 
     static const int DefaultLength;
     static const char* DefaultCustomCharacterSet;
@@ -82,6 +84,7 @@ public:
 
 private:
     QVector<PasswordGroup> passwordGroups() const;
+    QString generatePassword(const QVector<PasswordGroup>& groups, const QVector<QChar>& passwordChars) const;
     int numCharClasses() const;
 
     int m_length;
@@ -16,14 +16,26 @@
  */
 
 #include <QString>
+#include <QtConcurrent>
 
 #include "Group.h"
 #include "PasswordHealth.h"
+#include "crypto/CryptoHash.h"
 #include "zxcvbn.h"
 
 namespace
 {
     const static int ZXCVBN_ESTIMATE_THRESHOLD = 256;
+
+    QSharedPointer<const PasswordHealth> estimatePassword(const QString& pwd)
+    {
+        return QSharedPointer<const PasswordHealth>(new PasswordHealth(pwd));
+    }
+
+    QByteArray passwordDigest(const QString& pwd)
+    {
+        return CryptoHash::hash(pwd.toUtf8(), CryptoHash::Sha256);
+    }
 } // namespace
 
 PasswordHealth::PasswordHealth(double entropy)
@@ -116,12 +128,11 @@ PasswordHealth::Quality PasswordHealth::quality() const
 HealthChecker::HealthChecker(QSharedPointer<Database> db)
 {
     // Build the cache of re-used passwords
-    for (const auto* entry : db->rootGroup()->entriesRecursive()) {
+    db->rootGroup()->forEachEntryRecursive([this](const Entry* entry) {
         if (!entry->isRecycled() && !entry->isAttributeReference("Password")) {
-            m_reuse[entry->password()]
-                << QObject::tr("Used in %1/%2").arg(entry->group()->hierarchy().join('/'), entry->title());
+            m_reuse[entry->password()] << entry;
         }
-    }
+    });
 }
 
 /**
@@ -138,8 +149,17 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
     }
 
     // First analyse the password itself
+    return evaluate(entry, PasswordHealth(entry->password()));
+}
+
+QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry, const PasswordHealth& passwordHealth) const
+{
+    if (!entry) {
+        return {};
+    }
+
     const auto pwd = entry->password();
-    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(pwd));
+    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(passwordHealth));
 
     // Second, if the password is in the database more than once,
     // reduce the score accordingly
@@ -151,7 +171,11 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
         health->addScoreReason(QObject::tr("Password is used %1 time(s)", "", count).arg(QString::number(count)));
         // Add the first 20 uses of the password to prevent the details display from growing too large
         for (int i = 0; i < used.size(); ++i) {
-            health->addScoreDetails(used[i]);
+            const auto* other = used[i].data();
+            if (other && other->group()) {
+                health->addScoreDetails(
+                    QObject::tr("Used in %1/%2").arg(other->group()->hierarchy().join('/'), other->title()));
+            }
             if (i == 19) {
                 health->addScoreDetails("…");
                 break;
@@ -201,3 +225,141 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
     // Return the result
     return health;
 }
+
+PasswordHealthEngine::PasswordHealthEngine(QObject* parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, SIGNAL(resultReadyAt(int)), SLOT(passwordEstimated(int)));
+    connect(&m_watcher, SIGNAL(finished()), SLOT(estimationFinished()));
+}
+
+PasswordHealthEngine::~PasswordHealthEngine()
+{
+    cancel();
+}
+
+/**
+ * Evaluate the health of `entries` in the background.
+ *
+ * A running evaluation is cancelled first. entryEvaluated() is emitted
+ * once per entry, in no particular order, followed by finished().
+ * The entries must belong to `db`.
+ */
+void PasswordHealthEngine::start(QSharedPointer<Database> db, const QList<Entry*>& entries)
+{
+    cancel();
+
+    m_checker.reset(new HealthChecker(db));
+
+    QStringList passwords;
+    for (auto* entry : entries) {
+        const auto pwd = entry->password();
+        const auto digest = passwordDigest(pwd);
+        const auto estimate = m_estimates.value(digest);
+        if (estimate) {
+            emit entryEvaluated(entry, m_checker->evaluate(entry, *estimate));
+            continue;
+        }
+
+        if (!m_pendingEntries.contains(digest)) {
+            passwords << pwd;
+            m_pendingDigests << digest;
+        }
+        m_pendingEntries.insert(digest, entry);
+    }
+
+    if (passwords.isEmpty()) {
+        emit finished();
+        return;
+    }
+
+    m_watcher.setFuture(QtConcurrent::mapped(passwords, estimatePassword));
+}
+
+/**
+ * Stop a running evaluation. Results of entries that have not been
+ * reported yet are discarded and finished() is not emitted.
+ */
+void PasswordHealthEngine::cancel()
+{
+    if (m_watcher.isRunning()) {
+        m_watcher.cancel();
+        m_watcher.waitForFinished();
+    }
+
+    m_pendingDigests.clear();
+    m_pendingEntries.clear();
+}
+
+bool PasswordHealthEngine::isRunning() const
+{
+    return !m_pendingDigests.isEmpty();
+}
+
+/**
+ * Evaluate the health of `entries` and wait for the result.
+ * The returned list has one element per entry, in the same order.
+ */
+QList<QSharedPointer<PasswordHealth>> PasswordHealthEngine::evaluate(QSharedPointer<Database> db,
+                                                                     const QList<Entry*>& entries)
+{
+    HealthChecker checker(db);
+
+    QStringList passwords;
+    QList<QByteArray> passwordDigests;
+    QList<QByteArray> entryDigests;
+    QSet<QByteArray> queued;
+    for (const auto* entry : entries) {
+        const auto pwd = entry->password();
+        const auto digest = passwordDigest(pwd);
+        entryDigests << digest;
+        if (!m_estimates.contains(digest) && !queued.contains(digest)) {
+            queued.insert(digest);
+            passwords << pwd;
+            passwordDigests << digest;
+        }
+    }
+
+    // The estimates are returned in the order of the passwords
+    const auto estimates =
+        QtConcurrent::blockingMapped<QList<QSharedPointer<const PasswordHealth>>>(passwords, estimatePassword);
+    for (int i = 0; i < estimates.size(); ++i) {
+        m_estimates.insert(passwordDigests[i], estimates[i]);
+    }
+
+    QList<QSharedPointer<PasswordHealth>> results;
+    for (int i = 0; i < entries.size(); ++i) {
+        results << checker.evaluate(entries[i], *m_estimates.value(entryDigests[i]));
+    }
+    return results;
+}
+
+void PasswordHealthEngine::passwordEstimated(int index)
+{
+    // Ignore notifications that were still queued when the evaluation was cancelled
+    if (index >= m_pendingDigests.size()) {
+        return;
+    }
+
+    const auto digest = m_pendingDigests.value(index);
+    const auto estimate = m_watcher.resultAt(index);
+    m_estimates.insert(digest, estimate);
+
+    for (const auto& entry : m_pendingEntries.values(digest)) {
+        if (entry) {
+            emit entryEvaluated(entry, m_checker->evaluate(entry, *estimate));
+        }
+    }
+    m_pendingEntries.remove(digest);
+}
+
+void PasswordHealthEngine::estimationFinished()
+{
+    if (m_pendingDigests.isEmpty()) {
+        return;
+    }
+
+    m_pendingDigests.clear();
+    m_pendingEntries.clear();
+    emit finished();
+}
@@ -18,7 +18,9 @@
 #ifndef KEEPASSX_PASSWORDHEALTH_H
 #define KEEPASSX_PASSWORDHEALTH_H
 
+#include <QFutureWatcher>
 #include <QHash>
+#include <QPointer>
 #include <QSharedPointer>
 
 class Database;
@@ -109,10 +111,58 @@ public:
 
     // Get the health status of an entry in the database
     QSharedPointer<PasswordHealth> evaluate(const Entry* entry) const;
+    // Same as above, starting from an already computed health of the entry's password
+    QSharedPointer<PasswordHealth> evaluate(const Entry* entry, const PasswordHealth& passwordHealth) const;
 
 private:
     // To determine password re-use: first = password, second = entries that use it
-    QHash<QString, QStringList> m_reuse;
+    QHash<QString, QList<QPointer<const Entry>>> m_reuse;
+};
+
+/**
+ * Evaluates the health of many entries at once.
+ *
+ * Password strength estimation runs on the global thread pool, and
+ * each distinct password is only estimated once: estimates are kept
+ * per password digest for the lifetime of the engine, so running the
+ * engine again (e.g. after an entry was changed) only estimates new
+ * passwords. Re-use and expiry are then applied on the calling thread
+ * by a HealthChecker.
+ *
+ * @see HealthChecker
+ */
+class PasswordHealthEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PasswordHealthEngine(QObject* parent = nullptr);
+    ~PasswordHealthEngine() override;
+
+    // Evaluate entries in the background, reporting each result with entryEvaluated().
+    // Results that are already known are reported before start() returns.
+    void start(QSharedPointer<Database> db, const QList<Entry*>& entries);
+    void cancel();
+    bool isRunning() const;
+
+    // Evaluate entries in parallel and wait for the result, in the order of the entries
+    QList<QSharedPointer<PasswordHealth>> evaluate(QSharedPointer<Database> db, const QList<Entry*>& entries);
+
+signals:
+    void entryEvaluated(Entry* entry, QSharedPointer<PasswordHealth> health);
+    void finished();
+
+private slots:
+    void passwordEstimated(int index);
+    void estimationFinished();
+
+private:
+    QScopedPointer<HealthChecker> m_checker;
+    QHash<QByteArray, QSharedPointer<const PasswordHealth>> m_estimates;
+
+    QFutureWatcher<QSharedPointer<const PasswordHealth>> m_watcher;
+    QList<QByteArray> m_pendingDigests;
+    QMultiHash<QByteArray, QPointer<Entry>> m_pendingEntries;
 };
 
 #endif // KEEPASSX_PASSWORDHEALTH_H
@@ -22,20 +22,64 @@
 #include <QSharedPointer>
 
 #include <botan/system_rng.h>
+#ifdef BOTAN_HAS_CHACHA_RNG
+#include <botan/chacha_rng.h>
+#endif
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#ifdef Q_OS_UNIX
+#include <pthread.h>
+#endif
+
+namespace
+{
+    // Size of the buffer random numbers are taken from in BufferedDrbg mode
+    constexpr int BufferSize = 1024;
+
+    // Incremented in the child process after every fork()
+    std::atomic<quint32> forkGeneration{0};
+
+    void registerForkHandler()
+    {
+#ifdef Q_OS_UNIX
+        static std::once_flag registered;
+        std::call_once(registered, [] {
+            pthread_atfork(nullptr, nullptr, [] { forkGeneration.fetch_add(1, std::memory_order_relaxed); });
+        });
+#endif
+    }
+} // namespace
 
 QSharedPointer<Random> Random::m_instance;
+QSharedPointer<Random> Random::m_bufferedInstance;
 
-QSharedPointer<Random> Random::instance()
+QSharedPointer<Random> Random::instance(Mode mode)
 {
-    if (!m_instance) {
-        m_instance.reset(new Random());
+    auto& instance = mode == BufferedDrbg ? m_bufferedInstance : m_instance;
+    if (!instance) {
+        instance.reset(new Random(mode));
     }
-    return m_instance;
+    return instance;
 }
 
-Random::Random()
+Random::Random(Mode mode)
+    : m_mode(mode)
 {
+    if (mode == BufferedDrbg) {
+        registerForkHandler();
+    }
+
 #ifdef BOTAN_HAS_SYSTEM_RNG
+#ifdef BOTAN_HAS_CHACHA_RNG
+    if (mode == BufferedDrbg) {
+        // Reseeds itself from the system RNG after a number of requests and after fork()
+        m_rng.reset(new Botan::ChaCha_RNG(Botan::system_rng()));
+        return;
+    }
+#endif
     m_rng.reset(new Botan::System_RNG);
 #else
     m_rng.reset(new Botan::Autoseeded_RNG);
@@ -71,7 +115,7 @@ quint32 Random::randomUInt(quint32 limit)
 
     // To avoid modulo bias make sure rand is below the largest number where rand%limit==0
     do {
-        m_rng->randomize(reinterpret_cast<uint8_t*>(&rand), 4);
+        rand = nextUInt();
     } while (rand > ceil);
 
     return (rand % limit);
@@ -81,3 +125,31 @@ quint32 Random::randomUIntRange(quint32 min, quint32 max)
 {
     return min + randomUInt(max - min);
 }
+
+quint32 Random::nextUInt()
+{
+    quint32 rand;
+    if (m_mode != BufferedDrbg) {
+        m_rng->randomize(reinterpret_cast<uint8_t*>(&rand), sizeof(rand));
+        return rand;
+    }
+
+    QMutexLocker locker(&m_bufferMutex);
+    // After fork() parent and child would hand out the same numbers from the buffer,
+    // the DRBG itself reseeds when it detects the fork
+    const quint32 generation = forkGeneration.load(std::memory_order_relaxed);
+    if (generation != m_bufferForkGeneration || m_bufferOffset + static_cast<int>(sizeof(rand)) > m_buffer.size()) {
+        m_buffer.resize(BufferSize);
+        m_rng->randomize(reinterpret_cast<uint8_t*>(m_buffer.data()), m_buffer.size());
+        m_bufferOffset = 0;
+        m_bufferForkGeneration = generation;
+    }
+
+    // Wipe numbers from the buffer once they are handed out
+    char* data = m_buffer.data() + m_bufferOffset;
+    std::memcpy(&rand, data, sizeof(rand));
+    std::memset(data, 0, sizeof(rand));
+    m_bufferOffset += sizeof(rand);
+
+    return rand;
+}
@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_RANDOM_H
 #define KEEPASSX_RANDOM_H
 
+#include <QMutex>
 #include <QSharedPointer>
 
 #include <botan/rng.h>
@@ -25,7 +26,16 @@
 class Random
 {
 public:
-    static QSharedPointer<Random> instance();
+    enum Mode
+    {
+        // Every request is served by the system RNG
+        SystemRng,
+        // Requests are served by a ChaCha20 DRBG in userspace that is reseeded from the system RNG,
+        // random numbers are taken from a buffer. Meant for bulk generation of passwords.
+        BufferedDrbg
+    };
+
+    static QSharedPointer<Random> instance(Mode mode = SystemRng);
 
     void randomize(QByteArray& ba);
     QByteArray randomArray(int len);
@@ -43,16 +53,26 @@ public:
     QSharedPointer<Botan::RandomNumberGenerator> getRng();
 
 private:
-    explicit Random();
+    explicit Random(Mode mode);
     Q_DISABLE_COPY(Random);
 
+    quint32 nextUInt();
+
     static QSharedPointer<Random> m_instance;
+    static QSharedPointer<Random> m_bufferedInstance;
+    const Mode m_mode;
     QSharedPointer<Botan::RandomNumberGenerator> m_rng;
+
+    QMutex m_bufferMutex;
+    QByteArray m_buffer;
+    int m_bufferOffset = 0;
+    // Fork generation the buffer was filled in, a forked child must not reuse it
+    quint32 m_bufferForkGeneration = 0;
 };
 
-static inline QSharedPointer<Random> randomGen()
+static inline QSharedPointer<Random> randomGen(Random::Mode mode = Random::SystemRng)
 {
-    return Random::instance();
+    return Random::instance(mode);
 }
 
 #endif // KEEPASSX_RANDOM_H
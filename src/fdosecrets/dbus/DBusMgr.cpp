@@ -405,9 +405,29 @@ namespace FdoSecrets
             .arg(otherService);
     }
 
+    DBusObject* DBusMgr::findObject(const QString& path) const
+    {
+        auto parsed = parsePath(path);
+        if (parsed.type != PathType::Item) {
+            return m_objects.value(path, nullptr);
+        }
+
+        // Always go through the collection, it creates items on demand
+        // and keeps track of their use to evict idle ones
+        auto collPath = DBUS_PATH_TEMPLATE_COLLECTION.arg(DBUS_PATH_SECRETS, parsed.parentId);
+        auto coll = qobject_cast<Collection*>(m_objects.value(collPath, nullptr));
+        if (!coll) {
+            return nullptr;
+        }
+        return coll->findItem(parsed.id);
+    }
+
     bool DBusMgr::registerObject(const QString& path, DBusObject* obj, bool primary)
     {
-        if (!m_conn.registerVirtualObject(path, this)) {
+        // collections also receive calls for the item paths below them, see findObject
+        auto mode = parsePath(path).type == PathType::Collection ? QDBusConnection::SubPath
+                                                                 : QDBusConnection::SingleNode;
+        if (!m_conn.registerVirtualObject(path, this, mode)) {
             qDebug() << "failed to register" << obj << "at" << path;
             return false;
         }
@@ -478,11 +498,16 @@ namespace FdoSecrets
 
     bool DBusMgr::registerObject(Item* item)
     {
-        auto path = DBUS_PATH_TEMPLATE_ITEM.arg(item->collection()->objectPath().path(), item->backend()->uuidToHex());
-        if (!registerObject(path, item)) {
+        // the path is already served by the collection's SubPath registration,
+        // and Qt refuses to register nodes below it, so only remember the object
+        auto path = item->collection()->itemPath(item->backend()).path();
+        if (m_objects.contains(path)) {
             emit error(tr("Failed to register item on DBus at path '%1'").arg(path));
             return false;
         }
+        connect(item, &DBusObject::destroyed, this, &DBusMgr::unregisterObject);
+        m_objects.insert(path, item);
+        item->setObjectPath(path);
         return true;
     }
 
@@ -501,9 +526,12 @@ namespace FdoSecrets
 
     void DBusMgr::unregisterObject(DBusObject* obj)
     {
-        auto count = m_objects.remove(obj->objectPath().path());
+        auto path = obj->objectPath().path();
+        auto count = m_objects.remove(path);
         if (count > 0) {
-            m_conn.unregisterObject(obj->objectPath().path());
+            if (parsePath(path).type != PathType::Item) {
+                m_conn.unregisterObject(path);
+            }
             obj->setObjectPath("/");
         }
     }
@@ -551,48 +579,36 @@ namespace FdoSecrets
         sendDBusSignal(DBUS_PATH_SECRETS, DBUS_INTERFACE_SECRET_SERVICE, QStringLiteral("CollectionDeleted"), args);
     }
 
-    void DBusMgr::emitItemCreated(Item* item)
+    void DBusMgr::emitItemCreated(const QDBusObjectPath& item)
     {
-        auto coll = item->collection();
-        QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
-        // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemCreated"), args);
-        // also send on all alias path
-        for (const auto& alias : coll->aliases()) {
-            auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemCreated"), args);
-        }
+        emitItemSignal(qobject_cast<Collection*>(sender()), QStringLiteral("ItemCreated"), item);
     }
 
-    void DBusMgr::emitItemChanged(Item* item)
+    void DBusMgr::emitItemChanged(const QDBusObjectPath& item)
     {
-        auto coll = item->collection();
-        QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
-        // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemChanged"), args);
-        // also send on all alias path
-        for (const auto& alias : coll->aliases()) {
-            auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemChanged"), args);
-        }
+        emitItemSignal(qobject_cast<Collection*>(sender()), QStringLiteral("ItemChanged"), item);
     }
 
-    void DBusMgr::emitItemDeleted(Item* item)
+    void DBusMgr::emitItemDeleted(const QDBusObjectPath& item)
     {
-        auto coll = item->collection();
+        emitItemSignal(qobject_cast<Collection*>(sender()), QStringLiteral("ItemDeleted"), item);
+    }
+
+    void DBusMgr::emitItemSignal(const Collection* coll, const QString& name, const QDBusObjectPath& item)
+    {
+        if (!coll) {
+            qDebug() << "Wrong sender in emitItemSignal";
+            return;
+        }
+
         QVariantList args;
-        args += QVariant::fromValue(item->objectPath());
+        args += QVariant::fromValue(item);
         // send on primary path
-        sendDBusSignal(
-            coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemDeleted"), args);
+        sendDBusSignal(coll->objectPath().path(), DBUS_INTERFACE_SECRET_COLLECTION, name, args);
         // also send on all alias path
         for (const auto& alias : coll->aliases()) {
             auto path = DBUS_PATH_TEMPLATE_ALIAS.arg(DBUS_PATH_SECRETS, alias);
-            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, QStringLiteral("ItemDeleted"), args);
+            sendDBusSignal(path, DBUS_INTERFACE_SECRET_COLLECTION, name, args);
         }
     }
 
@@ -169,7 +169,7 @@ namespace FdoSecrets
             if (path.path() == QStringLiteral("/")) {
                 return nullptr;
             }
-            auto obj = qobject_cast<T*>(m_objects.value(path.path(), nullptr));
+            auto obj = qobject_cast<T*>(findObject(path.path()));
             if (!obj) {
                 qDebug() << "object not found at path" << path.path();
                 qDebug() << m_objects;
@@ -209,9 +209,9 @@ namespace FdoSecrets
         void emitCollectionCreated(Collection* coll);
         void emitCollectionChanged(Collection* coll);
         void emitCollectionDeleted(Collection* coll);
-        void emitItemCreated(Item* item);
-        void emitItemChanged(Item* item);
-        void emitItemDeleted(Item* item);
+        void emitItemCreated(const QDBusObjectPath& item);
+        void emitItemChanged(const QDBusObjectPath& item);
+        void emitItemDeleted(const QDBusObjectPath& item);
         void emitPromptCompleted(bool dismissed, QVariant result);
 
         void dbusServiceUnregistered(const QString& service);
@@ -226,6 +226,7 @@ namespace FdoSecrets
                             const QString& name,
                             const QVariantList& arguments);
         bool sendDBus(const QDBusMessage& reply);
+        void emitItemSignal(const Collection* coll, const QString& name, const QDBusObjectPath& item);
 
         // object path registration
         QHash<QString, QPointer<DBusObject>> m_objects{};
@@ -253,6 +254,11 @@ namespace FdoSecrets
             }
         };
         static ParsedPath parsePath(const QString& path);
+        /**
+         * Find the object at path. Items are not registered up front,
+         * they are created by their collection the first time they are looked up.
+         */
+        DBusObject* findObject(const QString& path) const;
         bool registerObject(const QString& path, DBusObject* obj, bool primary = true);
 
         // method dispatching
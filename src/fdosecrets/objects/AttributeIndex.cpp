@@ -0,0 +1,201 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AttributeIndex.h"
+
+#include "core/Database.h"
+#include "core/Global.h"
+#include "core/Group.h"
+
+namespace FdoSecrets
+{
+    namespace
+    {
+        // Keys that EntrySearcher compares after resolving placeholders, see Collection::attributeToTerm
+        bool isResolvedKey(const QString& key)
+        {
+            return key == EntryAttributes::TitleKey || key == EntryAttributes::UserNameKey
+                   || key == EntryAttributes::URLKey;
+        }
+    } // namespace
+
+    AttributeIndex::AttributeIndex(Database* db, Group* baseGroup, QObject* parent)
+        : QObject(parent)
+        , m_baseGroup(baseGroup)
+    {
+        connect(db, &Database::entryAdded, this, &AttributeIndex::addEntry);
+        connect(db, &Database::entryRemoved, this, &AttributeIndex::removeEntry);
+        connect(db, &Database::entryModified, this, &AttributeIndex::updateEntry);
+        // Whole subtrees can be attached, detached or moved without individual entry signals
+        connect(db, &Database::groupAdded, this, [this] { m_dirty = true; });
+        connect(db, &Database::groupRemoved, this, [this] { m_dirty = true; });
+        connect(db, &Database::groupMoved, this, [this] { m_dirty = true; });
+    }
+
+    QList<Entry*> AttributeIndex::candidates(const StringStringMap& attributes)
+    {
+        if (m_dirty) {
+            rebuild();
+        }
+        if (attributes.isEmpty() || !m_baseGroup) {
+            return {};
+        }
+
+        QSet<Entry*> found;
+        for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+            auto matching = m_unresolvedEntries.value(it.key());
+            auto values = m_entriesByValue.constFind(it.key());
+            if (values != m_entriesByValue.cend()) {
+                matching.unite(values->value(it.value()));
+            }
+
+            if (it == attributes.constBegin()) {
+                found = matching;
+            } else {
+                found.intersect(matching);
+            }
+            if (found.isEmpty()) {
+                return {};
+            }
+        }
+
+        if (found.size() == 1) {
+            return {*found.cbegin()};
+        }
+
+        // Same order as the walk done by EntrySearcher. Locating each candidate in its
+        // group instead would be quadratic for the typical case of one large flat group.
+        QList<Entry*> entries;
+        entries.reserve(found.size());
+        m_baseGroup->forEachEntryRecursive([&](Entry* entry) {
+            if (found.contains(entry)) {
+                entries.append(entry);
+            }
+            return entries.size() < found.size();
+        });
+        return entries;
+    }
+
+    void AttributeIndex::rebuild()
+    {
+        m_entriesByValue.clear();
+        m_unresolvedEntries.clear();
+        m_valuesByEntry.clear();
+
+        m_dirty = false;
+        if (!m_baseGroup) {
+            return;
+        }
+
+        m_baseGroup->forEachEntryRecursive([this](Entry* entry) { indexEntry(entry); });
+    }
+
+    void AttributeIndex::addEntry(Entry* entry)
+    {
+        if (!m_dirty && isBelowBaseGroup(entry)) {
+            indexEntry(entry);
+        }
+    }
+
+    void AttributeIndex::removeEntry(Entry* entry)
+    {
+        if (!m_dirty) {
+            unindexEntry(entry);
+        }
+    }
+
+    void AttributeIndex::updateEntry(Entry* entry)
+    {
+        if (!m_dirty && m_valuesByEntry.contains(entry)) {
+            indexEntry(entry);
+        }
+    }
+
+    void AttributeIndex::indexEntry(Entry* entry)
+    {
+        unindexEntry(entry);
+
+        auto& indexed = m_valuesByEntry[entry];
+        const auto attributes = entry->attributes();
+        for (const auto& key : attributes->keys()) {
+            // EntrySearcher ignores the terms for protected attributes, so their values
+            // are never needed (nor decrypted) here
+            bool unresolved =
+                !isResolvedKey(key) && key != EntryAttributes::NotesKey && attributes->isProtected(key);
+            QString value;
+            if (!unresolved) {
+                value = attributes->value(key);
+                // Placeholders depend on other entries
+                unresolved = isResolvedKey(key) && value.contains('{');
+            }
+            // Either way, these entries are left for EntrySearcher to decide
+            if (unresolved) {
+                m_unresolvedEntries[key].insert(entry);
+                indexed.append({key, {}});
+                continue;
+            }
+
+            m_entriesByValue[key][value].insert(entry);
+            indexed.append({key, value});
+            // an exact match pattern ends with '$', which also matches before a final newline
+            if (value.endsWith('\n')) {
+                value.chop(1);
+                m_entriesByValue[key][value].insert(entry);
+                indexed.append({key, value});
+            }
+        }
+    }
+
+    void AttributeIndex::unindexEntry(Entry* entry)
+    {
+        for (const auto& pair : m_valuesByEntry.take(entry)) {
+            auto unresolved = m_unresolvedEntries.find(pair.first);
+            if (unresolved != m_unresolvedEntries.end()) {
+                unresolved->remove(entry);
+                if (unresolved->isEmpty()) {
+                    m_unresolvedEntries.erase(unresolved);
+                }
+            }
+
+            auto values = m_entriesByValue.find(pair.first);
+            if (values == m_entriesByValue.end()) {
+                continue;
+            }
+            auto entries = values->find(pair.second);
+            if (entries != values->end()) {
+                entries->remove(entry);
+                if (entries->isEmpty()) {
+                    values->erase(entries);
+                }
+            }
+            if (values->isEmpty()) {
+                m_entriesByValue.erase(values);
+            }
+        }
+    }
+
+    bool AttributeIndex::isBelowBaseGroup(const Entry* entry) const
+    {
+        for (auto group = entry->group(); group; group = group->parentGroup()) {
+            if (group == m_baseGroup) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace FdoSecrets
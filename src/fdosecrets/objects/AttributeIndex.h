@@ -0,0 +1,75 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_FDOSECRETS_ATTRIBUTEINDEX_H
+#define KEEPASSXC_FDOSECRETS_ATTRIBUTEINDEX_H
+
+#include "fdosecrets/dbus/DBusTypes.h"
+
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+
+class Database;
+class Entry;
+class Group;
+
+namespace FdoSecrets
+{
+    /**
+     * Inverted index from attribute key and value to the entries below a group.
+     *
+     * The index only narrows down the entries that can possibly match the attributes
+     * of a SearchItems call, the actual matching is still done by EntrySearcher.
+     * Entries are always returned as candidates for a key when their value can't be
+     * compared directly, i.e. fields with placeholders and protected attributes.
+     */
+    class AttributeIndex : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        explicit AttributeIndex(Database* db, Group* baseGroup, QObject* parent = nullptr);
+
+        /**
+         * @param attributes the attributes that all have to match
+         * @return candidate entries, in the same order as a search below the base group
+         */
+        QList<Entry*> candidates(const StringStringMap& attributes);
+        void rebuild();
+
+    private:
+        void addEntry(Entry* entry);
+        void removeEntry(Entry* entry);
+        void updateEntry(Entry* entry);
+        void indexEntry(Entry* entry);
+        void unindexEntry(Entry* entry);
+        bool isBelowBaseGroup(const Entry* entry) const;
+
+        QPointer<Group> m_baseGroup;
+        bool m_dirty = true;
+
+        QHash<QString, QHash<QString, QSet<Entry*>>> m_entriesByValue;
+        // entries that have to be checked by EntrySearcher whatever value is requested
+        QHash<QString, QSet<Entry*>> m_unresolvedEntries;
+        // per entry, the keys and values it is indexed under
+        QHash<Entry*, QList<QPair<QString, QString>>> m_valuesByEntry;
+    };
+
+} // namespace FdoSecrets
+
+#endif // KEEPASSXC_FDOSECRETS_ATTRIBUTEINDEX_H
@@ -31,6 +31,12 @@
 
 namespace FdoSecrets
 {
+    namespace
+    {
+        // Items are evicted after being idle for one to two intervals
+        constexpr int ItemEvictionInterval = 30 * 1000;
+    } // namespace
+
     Collection* Collection::Create(Service* parent, DatabaseWidget* backend)
     {
         return new Collection(parent, backend);
@@ -56,6 +62,10 @@ namespace FdoSecrets
             }
             emit doneUnlockCollection(accepted);
         });
+
+        m_itemEvictionTimer.setInterval(ItemEvictionInterval);
+        connect(&m_itemEvictionTimer, &QTimer::timeout, this, &Collection::evictIdleItems);
+        connect(dbus().data(), &DBusMgr::clientDisconnected, this, &Collection::onClientDisconnected);
     }
 
     bool Collection::reloadBackend()
@@ -64,10 +74,7 @@ namespace FdoSecrets
 
         // delete all items
         // this has to be done because the backend is actually still there, just we don't expose them
-        // NOTE: Do NOT use a for loop, because Item::removeFromDBus will remove itself from m_items.
-        while (!m_items.isEmpty()) {
-            m_items.first()->removeFromDBus();
-        }
+        removeItems();
         cleanupConnections();
         dbus()->unregisterObject(this);
 
@@ -113,13 +120,22 @@ namespace FdoSecrets
         return {};
     }
 
-    DBusResult Collection::items(QList<Item*>& items) const
+    DBusResult Collection::items(QList<QDBusObjectPath>& items) const
     {
         auto ret = ensureBackend();
         if (ret.err()) {
             return ret;
         }
-        items = m_items;
+        items.clear();
+        if (backendLocked() || !m_exposedGroup) {
+            return {};
+        }
+        // only report the paths, items are created once a client actually uses them
+        m_exposedGroup->forEachEntryRecursive([&](const Entry* entry) {
+            if (!entry->isRecycled()) {
+                items.append(itemPath(entry));
+            }
+        });
         return {};
     }
 
@@ -230,8 +246,9 @@ namespace FdoSecrets
         if (attributes.contains(ItemAttributes::UuidKey)) {
             auto uuid = QUuid::fromRfc4122(QByteArray::fromHex(attributes.value(ItemAttributes::UuidKey).toLatin1()));
             auto entry = m_exposedGroup->findEntryByUuid(uuid);
-            if (entry) {
-                items += m_entryToItem.value(entry);
+            auto item = entry ? itemForEntry(entry) : nullptr;
+            if (item) {
+                items += item;
             }
             return {};
         }
@@ -239,8 +256,9 @@ namespace FdoSecrets
         if (attributes.contains(ItemAttributes::PathKey)) {
             auto path = attributes.value(ItemAttributes::PathKey);
             auto entry = m_exposedGroup->findEntryByPath(path);
-            if (entry) {
-                items += m_entryToItem.value(entry);
+            auto item = entry ? itemForEntry(entry) : nullptr;
+            if (item) {
+                items += item;
             }
             return {};
         }
@@ -250,14 +268,14 @@ namespace FdoSecrets
             terms << attributeToTerm(it.key(), it.value());
         }
 
+        // the index narrows down the entries by exact value, only those are matched by the searcher
         constexpr auto caseSensitive = false;
         constexpr auto skipProtected = true;
-        constexpr auto forceSearch = true;
-        const auto foundEntries =
-            EntrySearcher(caseSensitive, skipProtected).search(terms, m_exposedGroup, forceSearch);
+        const auto candidates = m_attributeIndex->candidates(attributes);
+        const auto foundEntries = EntrySearcher(caseSensitive, skipProtected).searchEntries(terms, candidates);
         items.reserve(foundEntries.size());
         for (const auto& entry : foundEntries) {
-            const auto item = m_entryToItem.value(entry);
+            const auto item = itemForEntry(entry);
             // it's possible that we don't have a corresponding item for the entry
             // this can happen when the recycle bin is below the exposed group.
             if (item) {
@@ -418,6 +436,7 @@ namespace FdoSecrets
         cleanupConnections();
 
         m_exposedGroup = newGroup;
+        m_attributeIndex.reset(new AttributeIndex(m_backend->database().data(), m_exposedGroup));
 
         // Attach signal to update exposed group settings if the group was removed.
         //
@@ -462,14 +481,10 @@ namespace FdoSecrets
             onDatabaseExposedGroupChanged();
         });
 
-        // Add items for existing entry
-        const auto entries = m_exposedGroup->entriesRecursive(false);
-        for (const auto& entry : entries) {
-            onEntryAdded(entry, false);
-        }
-
+        // Items are created lazily, see findItem. Only entry changes are tracked here.
         // Do not connect to Database::modified signal because we only want signals for the subset under m_exposedGroup
         connect(m_backend->database()->metadata(), &Metadata::modified, this, &Collection::collectionChanged);
+        connect(m_backend->database().data(), &Database::entryModified, this, &Collection::onEntryModified);
         connectGroupSignalRecursive(m_exposedGroup);
     }
 
@@ -478,9 +493,7 @@ namespace FdoSecrets
         // delete all items
         // this has to be done because the backend is actually still there
         // just we don't expose them
-        for (const auto& item : asConst(m_items)) {
-            item->removeFromDBus();
-        }
+        removeItems();
 
         // repopulate
         if (!backendLocked()) {
@@ -488,37 +501,129 @@ namespace FdoSecrets
         }
     }
 
-    void Collection::onEntryAdded(Entry* entry, bool emitSignal)
+    Item* Collection::findItem(const QString& uuidHex)
     {
-        if (entry->isRecycled()) {
-            return;
+        if (backendLocked() || !m_exposedGroup) {
+            return nullptr;
+        }
+        auto uuid = QUuid::fromRfc4122(QByteArray::fromHex(uuidHex.toLatin1()));
+        if (uuid.isNull()) {
+            return nullptr;
         }
+        auto entry = m_exposedGroup->findEntryByUuid(uuid);
+        if (!entry) {
+            return nullptr;
+        }
+        return itemForEntry(entry);
+    }
 
-        auto item = Item::Create(this, entry);
-        if (!item) {
-            return;
+    QDBusObjectPath Collection::itemPath(const Entry* entry) const
+    {
+        return QDBusObjectPath(DBUS_PATH_TEMPLATE_ITEM.arg(objectPath().path(), entry->uuidToHex()));
+    }
+
+    bool Collection::isExposed(const Entry* entry) const
+    {
+        if (!m_exposedGroup || entry->isRecycled()) {
+            return false;
+        }
+        for (auto group = entry->group(); group; group = group->parentGroup()) {
+            if (group == m_exposedGroup) {
+                return true;
+            }
         }
+        return false;
+    }
 
-        m_items << item;
-        m_entryToItem[entry] = item;
+    Item* Collection::itemForEntry(Entry* entry)
+    {
+        auto item = m_entryToItem.value(entry, nullptr);
+        if (item) {
+            m_usedItems.insert(entry);
+            return item;
+        }
+        if (!isExposed(entry)) {
+            return nullptr;
+        }
 
-        // forward delete signals
+        item = Item::Create(this, entry);
+        if (!item) {
+            return nullptr;
+        }
+        m_entryToItem.insert(entry, item);
+        m_usedItems.insert(entry);
+        if (!m_itemEvictionTimer.isActive()) {
+            m_itemEvictionTimer.start();
+        }
+
+        // the item goes away together with the entry, a later lookup creates a new one
         connect(entry->group(), &Group::entryAboutToRemove, item, [item](Entry* toBeRemoved) {
             if (item->backend() == toBeRemoved) {
                 item->removeFromDBus();
             }
         });
-
-        // relay signals
-        connect(item, &Item::itemChanged, this, [this, item]() { emit itemChanged(item); });
-        connect(item, &Item::itemAboutToDelete, this, [this, item]() {
-            m_items.removeAll(item);
-            m_entryToItem.remove(item->backend());
-            emit itemDeleted(item);
+        connect(item, &Item::itemAboutToDelete, this, [this, entry]() {
+            m_entryToItem.remove(entry);
+            m_usedItems.remove(entry);
         });
 
-        if (emitSignal) {
-            emit itemCreated(item);
+        return item;
+    }
+
+    void Collection::removeItems()
+    {
+        // NOTE: Do NOT use a for loop, because Item::removeFromDBus will remove itself from m_entryToItem.
+        while (!m_entryToItem.isEmpty()) {
+            m_entryToItem.begin().value()->removeFromDBus();
+        }
+        m_itemEvictionTimer.stop();
+    }
+
+    void Collection::evictIdleItems()
+    {
+        // Clients only know item paths, an evicted item is created again by the next call on its path.
+        // Prompts look their items up again as well, see ItemRef.
+        const auto items = m_entryToItem;
+        for (auto it = items.constBegin(); it != items.constEnd(); ++it) {
+            if (!m_usedItems.contains(it.key())) {
+                it.value()->removeFromDBus();
+            }
+        }
+        m_usedItems.clear();
+
+        if (m_entryToItem.isEmpty()) {
+            m_itemEvictionTimer.stop();
+        }
+    }
+
+    void Collection::onClientDisconnected(const DBusClientPtr& client)
+    {
+        // The client is still listed while the signal is emitted
+        const auto clients = dbus()->clients();
+        if (clients.isEmpty() || (clients.size() == 1 && clients.first() == client)) {
+            // nobody can hold an item anymore
+            removeItems();
+        }
+    }
+
+    void Collection::onEntryAdded(Entry* entry)
+    {
+        if (isExposed(entry)) {
+            emit itemCreated(itemPath(entry));
+        }
+    }
+
+    void Collection::onEntryAboutToRemove(Entry* entry)
+    {
+        if (isExposed(entry)) {
+            emit itemDeleted(itemPath(entry));
+        }
+    }
+
+    void Collection::onEntryModified(Entry* entry)
+    {
+        if (isExposed(entry)) {
+            emit itemChanged(itemPath(entry));
         }
     }
 
@@ -529,7 +634,8 @@ namespace FdoSecrets
         }
 
         connect(group, &Group::modified, this, &Collection::collectionChanged);
-        connect(group, &Group::entryAdded, this, [this](Entry* entry) { onEntryAdded(entry, true); });
+        connect(group, &Group::entryAdded, this, &Collection::onEntryAdded);
+        connect(group, &Group::entryAboutToRemove, this, &Collection::onEntryAboutToRemove);
 
         const auto children = group->children();
         for (const auto& cg : children) {
@@ -599,14 +705,14 @@ namespace FdoSecrets
 
     void Collection::cleanupConnections()
     {
+        m_attributeIndex.reset();
+        m_backend->database()->disconnect(this);
         m_backend->database()->metadata()->customData()->disconnect(this);
         if (m_exposedGroup) {
             for (const auto group : m_exposedGroup->groupsRecursive(true)) {
                 group->disconnect(this);
             }
         }
-
-        m_items.clear();
     }
 
     QString Collection::backendFilePath() const
@@ -690,8 +796,8 @@ namespace FdoSecrets
         // the item was just created so there is no point in having it not authorized
         client->setItemAuthorized(entry->uuid(), AuthDecision::Allowed);
 
-        // when creation finishes in backend, we will already have item
-        auto created = m_entryToItem.value(entry, nullptr);
+        // the client is going to use the new item right away
+        auto created = itemForEntry(entry);
 
         return created;
     }
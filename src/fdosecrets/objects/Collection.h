@@ -20,9 +20,12 @@
 
 #include "fdosecrets/dbus/DBusClient.h"
 #include "fdosecrets/dbus/DBusObject.h"
+#include "fdosecrets/objects/AttributeIndex.h"
 
 #include "core/EntrySearcher.h"
 
+#include <QTimer>
+
 class Database;
 class DatabaseWidget;
 class Entry;
@@ -52,7 +55,7 @@ namespace FdoSecrets
          */
         static Collection* Create(Service* parent, DatabaseWidget* backend);
 
-        Q_INVOKABLE DBUS_PROPERTY DBusResult items(QList<Item*>& items) const;
+        Q_INVOKABLE DBUS_PROPERTY DBusResult items(QList<QDBusObjectPath>& items) const;
 
         Q_INVOKABLE DBUS_PROPERTY DBusResult label(QString& label) const;
         Q_INVOKABLE DBusResult setLabel(const QString& label);
@@ -71,9 +74,9 @@ namespace FdoSecrets
         createItem(const QVariantMap& properties, const Secret& secret, bool replace, Item*& item, PromptBase*& prompt);
 
     signals:
-        void itemCreated(Item* item);
-        void itemDeleted(Item* item);
-        void itemChanged(Item* item);
+        void itemCreated(const QDBusObjectPath& item);
+        void itemDeleted(const QDBusObjectPath& item);
+        void itemChanged(const QDBusObjectPath& item);
 
         void collectionChanged();
         void collectionAboutToDelete();
@@ -110,6 +113,15 @@ namespace FdoSecrets
 
         static EntrySearcher::SearchTerm attributeToTerm(const QString& key, const QString& value);
 
+        /**
+         * Items are only created when a client uses them, and evicted again
+         * once they were not used for a while, see evictIdleItems.
+         * @param uuidHex the uuid of the backing entry, as found in the item path
+         * @return the item, or nullptr if no such entry is exposed
+         */
+        Item* findItem(const QString& uuidHex);
+        QDBusObjectPath itemPath(const Entry* entry) const;
+
     public slots:
         // expose some methods for Prompt to use
 
@@ -128,6 +140,9 @@ namespace FdoSecrets
         // force reload info from backend, potentially delete self
         bool reloadBackend();
 
+        // Remove the items not used since the last call, runs periodically while there are items
+        void evictIdleItems();
+
     private slots:
         void onDatabaseLockChanged();
         void onDatabaseExposedGroupChanged();
@@ -139,7 +154,13 @@ namespace FdoSecrets
         friend class DeleteCollectionPrompt;
         friend class CreateCollectionPrompt;
 
-        void onEntryAdded(Entry* entry, bool emitSignal);
+        void onEntryAdded(Entry* entry);
+        void onEntryAboutToRemove(Entry* entry);
+        void onEntryModified(Entry* entry);
+        void onClientDisconnected(const DBusClientPtr& client);
+        bool isExposed(const Entry* entry) const;
+        Item* itemForEntry(Entry* entry);
+        void removeItems();
         void populateContents();
         void connectGroupSignalRecursive(Group* group);
         void cleanupConnections();
@@ -171,8 +192,12 @@ namespace FdoSecrets
         QPointer<Group> m_exposedGroup;
 
         QSet<QString> m_aliases;
-        QList<Item*> m_items;
-        QMap<const Entry*, Item*> m_entryToItem;
+        // only the items currently in use by clients
+        QHash<const Entry*, Item*> m_entryToItem;
+        // entries whose item was used since the last eviction
+        QSet<const Entry*> m_usedItems;
+        QTimer m_itemEvictionTimer;
+        QScopedPointer<AttributeIndex> m_attributeIndex;
     };
 
 } // namespace FdoSecrets
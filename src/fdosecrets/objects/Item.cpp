@@ -73,7 +73,6 @@ namespace FdoSecrets
         : DBusObject(parent)
         , m_backend(backend)
     {
-        connect(m_backend, &Entry::modified, this, &Item::itemChanged);
     }
 
     DBusResult Item::locked(const DBusClientPtr& client, bool& locked) const
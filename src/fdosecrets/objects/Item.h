@@ -72,7 +72,6 @@ namespace FdoSecrets
         Q_INVOKABLE DBusResult setSecret(const DBusClientPtr& client, const Secret& secret);
 
     signals:
-        void itemChanged();
         void itemAboutToDelete();
 
     public:
@@ -35,6 +35,24 @@ namespace FdoSecrets
 {
     const PromptResult PromptResult::Pending{PromptResult::AsyncPending};
 
+    ItemRef::ItemRef(Item* item)
+        : m_item(item)
+    {
+        if (item && item->backend()) {
+            m_collection = item->collection();
+            m_uuidHex = item->backend()->uuidToHex();
+        }
+    }
+
+    Item* ItemRef::get() const
+    {
+        // an evicted item may still wait for its deletion, but it has no backend anymore
+        if ((!m_item || !m_item->backend()) && m_collection) {
+            m_item = m_collection->findItem(m_uuidHex);
+        }
+        return m_item;
+    }
+
     PromptBase::PromptBase(Service* parent)
         : DBusObject(parent)
     {
@@ -213,7 +231,7 @@ namespace FdoSecrets
             m_collections << coll;
         }
         for (const auto& item : asConst(items)) {
-            m_items[item->collection()] << item;
+            m_items[item->collection()] << ItemRef(item);
         }
     }
 
@@ -292,7 +310,8 @@ namespace FdoSecrets
         // flatten to list of entries
         QList<Entry*> entries;
         for (const auto& itemsPerColl : asConst(m_items)) {
-            for (const auto& item : itemsPerColl) {
+            for (const auto& itemRef : itemsPerColl) {
+                auto item = itemRef.get();
                 if (!item) {
                     m_numRejected += 1;
                     continue;
@@ -306,7 +325,7 @@ namespace FdoSecrets
                     // Already saw this entry
                     continue;
                 }
-                m_entryToItems[uuid] = item.data();
+                m_entryToItems[uuid] = itemRef;
                 entries << entry;
             }
         }
@@ -334,7 +353,7 @@ namespace FdoSecrets
             auto entry = it.key();
             auto uuid = entry->uuid();
             // get back the corresponding item
-            auto item = m_entryToItems.value(uuid);
+            auto item = m_entryToItems.value(uuid).get();
             if (!item) {
                 continue;
             }
@@ -366,10 +385,11 @@ namespace FdoSecrets
     {
         MessageBox::OverrideParent override(findWindow(windowId));
 
-        // if m_item is gone, assume it's already deleted
+        // if the entry is gone, assume it's already deleted
         bool deleted = true;
-        if (m_item) {
-            deleted = m_item->doDelete();
+        auto item = m_item.get();
+        if (item) {
+            deleted = item->doDelete();
         }
         return PromptResult::accepted(deleted);
     }
@@ -384,7 +404,6 @@ namespace FdoSecrets
         , m_properties(std::move(properties))
         , m_secret(std::move(secret))
         , m_replace(replace)
-        , m_item(nullptr)
         // session aliveness also need to be tracked, for potential use later in updateItem
         , m_sess(m_secret.session)
     {
@@ -392,7 +411,7 @@ namespace FdoSecrets
 
     QVariant CreateItemPrompt::currentResult() const
     {
-        return QVariant::fromValue(DBusMgr::objectPathSafe(m_item));
+        return QVariant::fromValue(DBusMgr::objectPathSafe(m_item.get()));
     }
 
     PromptResult CreateItemPrompt::promptSync(const DBusClientPtr& client, const QString& windowId)
@@ -462,22 +481,24 @@ namespace FdoSecrets
                 return ret;
             }
             if (!existing.isEmpty() && m_replace) {
-                m_item = existing.front();
+                m_item = ItemRef(existing.front());
             }
         }
 
-        if (!m_item) {
+        auto item = m_item.get();
+        if (!item) {
             // the item doesn't exist yet, create it
-            m_item = m_coll->doNewItem(client, itemPath);
-            if (!m_item) {
+            item = m_coll->doNewItem(client, itemPath);
+            if (!item) {
                 // may happen if entry somehow ends up in recycle bin
                 return DBusResult{DBUS_ERROR_SECRET_NO_SUCH_OBJECT};
             }
+            m_item = ItemRef(item);
         }
 
         // the item may be locked due to authorization
         // give the user a chance to unlock the item
-        auto prompt = PromptBase::Create<UnlockPrompt>(service(), QSet<Collection*>{}, QSet<Item*>{m_item});
+        auto prompt = PromptBase::Create<UnlockPrompt>(service(), QSet<Collection*>{}, QSet<Item*>{item});
         if (!prompt) {
             return DBusResult{QDBusError::InternalError};
         }
@@ -512,14 +533,15 @@ namespace FdoSecrets
         if (!m_sess || m_sess != m_secret.session) {
             return DBusResult(DBUS_ERROR_SECRET_NO_SESSION);
         }
-        if (!m_item) {
+        auto item = m_item.get();
+        if (!item) {
             return {};
         }
-        auto ret = m_item->setProperties(m_properties);
+        auto ret = item->setProperties(m_properties);
         if (ret.err()) {
             return ret;
         }
-        ret = m_item->setSecret(client, m_secret);
+        ret = item->setSecret(client, m_secret);
         if (ret.err()) {
             return ret;
         }
@@ -115,6 +115,28 @@ namespace FdoSecrets
     };
 
     class Collection;
+    class Item;
+
+    /**
+     * Items are evicted while no client uses them, so prompts refer to an item
+     * by its collection and entry uuid as well, and look it up again when needed.
+     */
+    class ItemRef
+    {
+    public:
+        ItemRef() = default;
+        explicit ItemRef(Item* item);
+
+        /**
+         * @return the item, or nullptr if its entry is gone or no longer exposed
+         */
+        Item* get() const;
+
+    private:
+        mutable QPointer<Item> m_item;
+        QPointer<Collection> m_collection;
+        QString m_uuidHex;
+    };
 
     class DeleteCollectionPrompt : public PromptBase
     {
@@ -173,8 +195,8 @@ namespace FdoSecrets
         void unlockItems();
 
         QList<QPointer<Collection>> m_collections;
-        QHash<Collection*, QList<QPointer<Item>>> m_items;
-        QHash<QUuid, Item*> m_entryToItems;
+        QHash<Collection*, QList<ItemRef>> m_items;
+        QHash<QUuid, ItemRef> m_entryToItems;
 
         QList<QDBusObjectPath> m_unlocked;
         int m_numRejected = 0;
@@ -184,7 +206,6 @@ namespace FdoSecrets
         QString m_windowId;
     };
 
-    class Item;
     class DeleteItemPrompt : public PromptBase
     {
         Q_OBJECT
@@ -194,7 +215,7 @@ namespace FdoSecrets
 
         PromptResult promptSync(const DBusClientPtr& client, const QString& windowId) override;
 
-        QPointer<Item> m_item;
+        ItemRef m_item;
     };
 
     class CreateItemPrompt : public PromptBase
@@ -219,7 +240,7 @@ namespace FdoSecrets
         Secret m_secret;
         bool m_replace;
 
-        QPointer<Item> m_item;
+        ItemRef m_item;
 
         QPointer<const Session> m_sess;
         QWeakPointer<DBusClient> m_client;
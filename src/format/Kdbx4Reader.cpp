@@ -27,6 +27,7 @@
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2RandomStream.h"
 #include "streams/HmacBlockStream.h"
+#include "streams/ReadAheadStream.h"
 #include "streams/StoreDataStream.h"
 #include "streams/SymmetricCipherStream.h"
 #include "streams/qtiocompressor.h"
@@ -85,12 +86,20 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
         return false;
     }
 
+    // Every layer below reads its input through a ReadAheadStream, so block verification, decryption,
+    // decompression and XML parsing run concurrently on separate threads instead of one after another.
+    ReadAheadStream hmacStage(&hmacStream);
+    if (!hmacStage.open(QIODevice::ReadOnly)) {
+        raiseError(hmacStage.errorString());
+        return false;
+    }
+
     auto mode = SymmetricCipher::cipherUuidToMode(db->cipher());
     if (mode == SymmetricCipher::InvalidMode) {
         raiseError(tr("Unknown cipher"));
         return false;
     }
-    SymmetricCipherStream cipherStream(&hmacStream);
+    SymmetricCipherStream cipherStream(&hmacStage);
     if (!cipherStream.init(mode, SymmetricCipher::Decrypt, finalKey, m_encryptionIV)) {
         raiseError(cipherStream.errorString());
         return false;
@@ -101,19 +110,31 @@ bool Kdbx4Reader::readDatabaseImpl(QIODevice* device,
     }
     // clang-format on
 
+    ReadAheadStream cipherStage(&cipherStream);
+    if (!cipherStage.open(QIODevice::ReadOnly)) {
+        raiseError(cipherStage.errorString());
+        return false;
+    }
+
     QIODevice* xmlDevice = nullptr;
     QScopedPointer<QtIOCompressor> ioCompressor;
+    QScopedPointer<ReadAheadStream> compressorStage;
 
     if (db->compressionAlgorithm() == Database::CompressionNone) {
-        xmlDevice = &cipherStream;
+        xmlDevice = &cipherStage;
     } else {
-        ioCompressor.reset(new QtIOCompressor(&cipherStream));
+        ioCompressor.reset(new QtIOCompressor(&cipherStage));
         ioCompressor->setStreamFormat(QtIOCompressor::GzipFormat);
         if (!ioCompressor->open(QIODevice::ReadOnly)) {
             raiseError(ioCompressor->errorString());
             return false;
         }
-        xmlDevice = ioCompressor.data();
+        compressorStage.reset(new ReadAheadStream(ioCompressor.data()));
+        if (!compressorStage->open(QIODevice::ReadOnly)) {
+            raiseError(compressorStage->errorString());
+            return false;
+        }
+        xmlDevice = compressorStage.data();
     }
 
     while (readInnerHeaderField(xmlDevice) && !hasError()) {
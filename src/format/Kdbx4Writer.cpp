@@ -217,38 +217,41 @@ bool Kdbx4Writer::writeInnerHeaderField(QIODevice* device, KeePass2::InnerHeader
 
 KdbxXmlWriter::BinaryIdxMap Kdbx4Writer::writeAttachments(QIODevice* device, Database* db)
 {
-    const QList<Entry*> allEntries = db->rootGroup()->entriesRecursive(true);
     QHash<QByteArray, qint64> writtenAttachments;
     KdbxXmlWriter::BinaryIdxMap idxMap;
     qint64 nextIdx = 0;
 
-    for (const Entry* entry : allEntries) {
-        const QList<QString> attachmentKeys = entry->attachments()->keys();
-        for (const QString& key : attachmentKeys) {
-            QByteArray data("\x01");
-            data.append(entry->attachments()->value(key));
+    db->rootGroup()->forEachEntryRecursive(
+        [&](const Entry* entry) {
+            const QList<QString> attachmentKeys = entry->attachments()->keys();
+            if (attachmentKeys.isEmpty()) {
+                return;
+            }
 
-            CryptoHash hash(CryptoHash::Sha256);
+            QByteArray salt;
 #ifdef WITH_XC_KEESHARE
             // Namespace KeeShare attachments so they don't get deduplicated together with attachments
             // from other databases. Prevents potential filesize side channels.
             if (auto shared = KeeShare::resolveSharedGroup(entry->group())) {
-                hash.addData(KeeShare::referenceOf(shared).uuid.toByteArray());
+                salt = KeeShare::referenceOf(shared).uuid.toByteArray();
             } else {
-                hash.addData(db->uuid().toByteArray());
+                salt = db->uuid().toByteArray();
             }
 #endif
-            hash.addData(data);
 
-            // Deduplicate attachments with the same hash
-            const auto hashResult = hash.result();
-            if (!writtenAttachments.contains(hashResult)) {
-                writeInnerHeaderField(device, KeePass2::InnerHeaderFieldID::Binary, data);
-                writtenAttachments.insert(hashResult, nextIdx++);
+            for (const QString& key : attachmentKeys) {
+                // Deduplicate attachments with the same (cached) digest
+                const auto hashResult = salt + entry->attachments()->hash(key);
+                if (!writtenAttachments.contains(hashResult)) {
+                    QByteArray data("\x01");
+                    data.append(entry->attachments()->value(key));
+                    writeInnerHeaderField(device, KeePass2::InnerHeaderFieldID::Binary, data);
+                    writtenAttachments.insert(hashResult, nextIdx++);
+                }
+                idxMap.insert(qMakePair(entry, key), writtenAttachments[hashResult]);
             }
-            idxMap.insert(qMakePair(entry, key), writtenAttachments[hashResult]);
-        }
-    }
+        },
+        true);
 
     return idxMap;
 }
@@ -92,6 +92,8 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
     m_meta->setUpdateDatetime(false);
 
     m_randomStream = randomStream;
+    // Protected entry strings are decrypted on access, after the reader is gone
+    m_lazyStream = randomStream ? randomStream->clone() : QSharedPointer<const KeePass2RandomStream>();
     m_headerHash.clear();
 
     m_tmpParent.reset(new Group());
@@ -133,10 +135,16 @@ void KdbxXmlReader::readDatabase(QIODevice* device, Database* db, KeePass2Random
         qWarning("KdbxXmlReader::readDatabase: found unused key \"%s\"", qPrintable(key));
     }
 
+    // Attachments referencing the same binary share its data and digest
+    QHash<QString, QSharedPointer<const EntryAttachments::Blob>> blobs;
     QHash<QString, QPair<Entry*, QString>>::const_iterator i;
     for (i = m_binaryMap.constBegin(); i != m_binaryMap.constEnd(); ++i) {
+        auto& blob = blobs[i.key()];
+        if (!blob) {
+            blob = QSharedPointer<const EntryAttachments::Blob>::create(m_binaryPool[i.key()]);
+        }
         const QPair<Entry*, QString>& target = i.value();
-        target.first->attachments()->set(target.second, m_binaryPool[i.key()]);
+        target.first->attachments()->setBlob(target.second, blob);
     }
 
     m_meta->setUpdateDatetime(true);
@@ -826,6 +834,7 @@ void KdbxXmlReader::parseEntryString(Entry* entry)
 
     QString key;
     QString value;
+    QSharedPointer<const EntryAttributes::LazyValue> lazyValue;
     bool protect = false;
     bool keySet = false;
     bool valueSet = false;
@@ -839,10 +848,17 @@ void KdbxXmlReader::parseEntryString(Entry* entry)
 
         if (m_xml.name() == "Value") {
             QXmlStreamAttributes attr = m_xml.attributes();
-            bool isProtected;
-            bool protectInMemory;
-            value = readString(isProtected, protectInMemory);
-            protect = isProtected || protectInMemory;
+            if (m_lazyStream && isTrueValue(attr.value("Protected"))) {
+                lazyValue = readLazyString();
+                value.clear();
+                protect = true;
+            } else {
+                bool isProtected;
+                bool protectInMemory;
+                value = readString(isProtected, protectInMemory);
+                lazyValue.reset();
+                protect = isProtected || protectInMemory;
+            }
             valueSet = true;
             continue;
         }
@@ -856,7 +872,11 @@ void KdbxXmlReader::parseEntryString(Entry* entry)
             raiseError(tr("Duplicate custom attribute found"));
             return;
         }
-        entry->attributes()->set(key, value, protect);
+        if (lazyValue) {
+            entry->attributes()->setLazy(key, lazyValue);
+        } else {
+            entry->attributes()->set(key, value, protect);
+        }
         return;
     }
 
@@ -1034,6 +1054,28 @@ QString KdbxXmlReader::readString(bool& isProtected, bool& protectInMemory)
     return value;
 }
 
+/**
+ * Read a protected string without decrypting it. The random stream is advanced
+ * past the value, which is decrypted from its stream position when accessed.
+ *
+ * @return lazy value or null if the string is empty
+ */
+QSharedPointer<const EntryAttributes::LazyValue> KdbxXmlReader::readLazyString()
+{
+    QByteArray ciphertext = QByteArray::fromBase64(m_xml.readElementText().toLatin1());
+    if (ciphertext.isEmpty()) {
+        return {};
+    }
+
+    const quint64 position = m_randomStream->position();
+    if (!m_randomStream->skip(ciphertext.size())) {
+        raiseError(m_randomStream->errorString());
+        return {};
+    }
+
+    return QSharedPointer<const EntryAttributes::LazyValue>::create(ciphertext, position, m_lazyStream);
+}
+
 bool KdbxXmlReader::readBool()
 {
     QString str = readString();
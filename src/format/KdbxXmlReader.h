@@ -19,6 +19,7 @@
 #define KEEPASSXC_KDBXXMLREADER_H
 
 #include "core/Database.h"
+#include "core/EntryAttributes.h"
 #include "core/Metadata.h"
 
 #include <QCoreApplication>
@@ -79,6 +80,7 @@ protected:
 
     virtual QString readString();
     virtual QString readString(bool& isProtected, bool& protectInMemory);
+    virtual QSharedPointer<const EntryAttributes::LazyValue> readLazyString();
     virtual bool readBool();
     virtual QDateTime readDateTime();
     virtual QString readColor();
@@ -102,6 +104,7 @@ protected:
     QPointer<Database> m_db;
     QPointer<Metadata> m_meta;
     KeePass2RandomStream* m_randomStream = nullptr;
+    QSharedPointer<const KeePass2RandomStream> m_lazyStream;
     QXmlStreamReader m_xml;
 
     QScopedPointer<Group> m_tmpParent;
@@ -22,7 +22,6 @@
 #include <QMap>
 
 #include "core/Endian.h"
-#include "crypto/CryptoHash.h"
 #include "format/KeePass2RandomStream.h"
 #include "keeshare/KeeShare.h"
 #include "keeshare/KeeShareSettings.h"
@@ -102,33 +101,37 @@ QString KdbxXmlWriter::errorString()
  */
 void KdbxXmlWriter::fillBinaryIdxMap()
 {
-    const QList<Entry*> allEntries = m_db->rootGroup()->entriesRecursive(true);
     QHash<QByteArray, qint64> writtenAttachments;
     qint64 nextIdx = 0;
 
-    for (Entry* entry : allEntries) {
-        const QList<QString> attachmentKeys = entry->attachments()->keys();
-        for (const QString& key : attachmentKeys) {
-            QByteArray data = entry->attachments()->value(key);
-            CryptoHash hash(CryptoHash::Sha256);
+    m_db->rootGroup()->forEachEntryRecursive(
+        [&](Entry* entry) {
+            const QList<QString> attachmentKeys = entry->attachments()->keys();
+            if (attachmentKeys.isEmpty()) {
+                return;
+            }
+
+            QByteArray salt;
 #ifdef WITH_XC_KEESHARE
             // Namespace KeeShare attachments so they don't get deduplicated together with attachments
             // from other databases. Prevents potential filesize side channels.
             if (auto shared = KeeShare::resolveSharedGroup(entry->group())) {
-                hash.addData(KeeShare::referenceOf(shared).uuid.toByteArray());
+                salt = KeeShare::referenceOf(shared).uuid.toByteArray();
             } else {
-                hash.addData(m_db->uuid().toByteArray());
+                salt = m_db->uuid().toByteArray();
             }
 #endif
-            hash.addData(data);
 
-            const auto hashResult = hash.result();
-            if (!writtenAttachments.contains(hashResult)) {
-                writtenAttachments.insert(hashResult, nextIdx++);
+            for (const QString& key : attachmentKeys) {
+                // The attachment digest is cached, so unchanged attachments are not rehashed on every save
+                const auto hashResult = salt + entry->attachments()->hash(key);
+                if (!writtenAttachments.contains(hashResult)) {
+                    writtenAttachments.insert(hashResult, nextIdx++);
+                }
+                m_binaryIdxMap.insert(qMakePair(entry, key), writtenAttachments.value(hashResult));
             }
-            m_binaryIdxMap.insert(qMakePair(entry, key), writtenAttachments.value(hashResult));
-        }
-    }
+        },
+        true);
 }
 
 void KdbxXmlWriter::writeMetadata()
@@ -430,22 +433,28 @@ void KdbxXmlWriter::writeEntry(const Entry* entry)
 
         m_xml.writeStartElement("Value");
         QString value;
+        bool decrypted;
 
         if (protect) {
             if (!m_innerStreamProtectionDisabled && m_randomStream) {
                 m_xml.writeAttribute("Protected", "True");
                 bool ok;
-                QByteArray rawData = m_randomStream->process(entry->attributes()->value(key).toUtf8(), &ok);
+                QByteArray rawData = m_randomStream->process(entry->attributes()->valueUtf8(key, &decrypted), &ok);
                 if (!ok) {
                     raiseError(m_randomStream->errorString());
                 }
                 value = QString::fromLatin1(rawData.toBase64());
             } else {
                 m_xml.writeAttribute("ProtectInMemory", "True");
-                value = entry->attributes()->value(key);
+                value = entry->attributes()->value(key, &decrypted);
             }
         } else {
-            value = entry->attributes()->value(key);
+            value = entry->attributes()->value(key, &decrypted);
+        }
+
+        // Never replace a protected value that can't be decrypted with an empty one
+        if (!decrypted) {
+            raiseError(QObject::tr("Failed to decrypt protected attribute \"%1\"").arg(key));
         }
 
         if (!value.isEmpty()) {
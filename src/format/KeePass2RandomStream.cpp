@@ -20,100 +20,151 @@
 #include "crypto/CryptoHash.h"
 #include "format/KeePass2.h"
 
+#include <QObject>
+#include <botan/stream_cipher.h>
+
 bool KeePass2RandomStream::init(SymmetricCipher::Mode mode, const QByteArray& key)
 {
     switch (mode) {
     case SymmetricCipher::Salsa20: {
-        return m_cipher.init(mode,
-                             SymmetricCipher::Encrypt,
-                             CryptoHash::hash(key, CryptoHash::Sha256),
-                             KeePass2::INNER_STREAM_SALSA20_IV);
+        m_cipherKey = CryptoHash::hash(key, CryptoHash::Sha256);
+        m_iv = KeePass2::INNER_STREAM_SALSA20_IV;
+        break;
     }
     case SymmetricCipher::ChaCha20: {
         QByteArray keyIv = CryptoHash::hash(key, CryptoHash::Sha512);
-        return m_cipher.init(mode, SymmetricCipher::Encrypt, keyIv.left(32), keyIv.mid(32, 12));
+        m_cipherKey = keyIv.left(32);
+        m_iv = keyIv.mid(32, 12);
+        break;
     }
     default:
         qWarning("Invalid stream cipher mode (%d)", mode);
-        break;
+        return false;
     }
-    return false;
+
+    m_mode = mode;
+    m_key = key;
+    m_position = 0;
+    m_cipher = createCipher();
+    return !m_cipher.isNull();
 }
 
 QByteArray KeePass2RandomStream::randomBytes(int size, bool* ok)
 {
-    QByteArray result;
-
-    int bytesRemaining = size;
-
-    while (bytesRemaining > 0) {
-        if (m_buffer.size() == m_offset) {
-            if (!loadBlock()) {
-                *ok = false;
-                return {};
-            }
-        }
-
-        int bytesToCopy = qMin(bytesRemaining, m_buffer.size() - m_offset);
-        result.append(m_buffer.mid(m_offset, bytesToCopy));
-        m_offset += bytesToCopy;
-        bytesRemaining -= bytesToCopy;
+    QByteArray result(size, '\0');
+    *ok = processInPlace(result);
+    if (!*ok) {
+        return {};
     }
-
-    *ok = true;
     return result;
 }
 
 QByteArray KeePass2RandomStream::process(const QByteArray& data, bool* ok)
 {
-    bool randomBytesOk;
-
-    QByteArray randomData = randomBytes(data.size(), &randomBytesOk);
-    if (!randomBytesOk) {
-        *ok = false;
+    QByteArray result = data;
+    *ok = processInPlace(result);
+    if (!*ok) {
         return {};
     }
-
-    QByteArray result;
-    result.resize(data.size());
-
-    for (int i = 0; i < data.size(); i++) {
-        result[i] = data[i] ^ randomData[i];
-    }
-
-    *ok = true;
     return result;
 }
 
 bool KeePass2RandomStream::processInPlace(QByteArray& data)
 {
-    bool ok;
-    QByteArray randomData = randomBytes(data.size(), &ok);
-    if (!ok) {
+    if (!m_cipher) {
+        m_error = QObject::tr("Cipher not initialized prior to use.");
+        return false;
+    }
+
+    try {
+        // The stream cipher XORs the key stream into the data
+        m_cipher->cipher1(reinterpret_cast<uint8_t*>(data.data()), data.size());
+        m_position += data.size();
+        return true;
+    } catch (std::exception& e) {
+        m_error = e.what();
         return false;
     }
+}
 
-    for (int i = 0; i < data.size(); i++) {
-        data[i] = data[i] ^ randomData[i];
+/**
+ * Advance the stream without generating the skipped key stream.
+ * The skipped data can still be processed later using processAt().
+ */
+bool KeePass2RandomStream::skip(int size)
+{
+    if (!m_cipher) {
+        m_error = QObject::tr("Cipher not initialized prior to use.");
+        return false;
     }
 
-    return true;
+    try {
+        m_cipher->seek(m_position + size);
+        m_position += size;
+        return true;
+    } catch (std::exception& e) {
+        m_error = e.what();
+        return false;
+    }
 }
 
-QString KeePass2RandomStream::errorString() const
+/**
+ * Number of bytes processed or skipped since the stream was initialized.
+ */
+quint64 KeePass2RandomStream::position() const
 {
-    return m_cipher.errorString();
+    return m_position;
 }
 
-bool KeePass2RandomStream::loadBlock()
+/**
+ * Process data that starts at the given stream position without
+ * affecting the position of this stream. Safe to call from any thread.
+ */
+bool KeePass2RandomStream::processAt(QByteArray& data, quint64 position) const
 {
-    Q_ASSERT(m_offset == m_buffer.size());
+    auto cipher = createCipher();
+    if (!cipher) {
+        return false;
+    }
 
-    m_buffer.fill('\0', m_cipher.blockSize(m_cipher.mode()));
-    if (!m_cipher.process(m_buffer)) {
+    try {
+        cipher->seek(position);
+        cipher->cipher1(reinterpret_cast<uint8_t*>(data.data()), data.size());
+        return true;
+    } catch (std::exception& e) {
+        qWarning("KeePass2RandomStream::processAt: Could not process: %s", e.what());
         return false;
     }
-    m_offset = 0;
+}
+
+/**
+ * Create a new stream with the same key, positioned at the start of the stream.
+ */
+QSharedPointer<const KeePass2RandomStream> KeePass2RandomStream::clone() const
+{
+    auto stream = QSharedPointer<KeePass2RandomStream>::create();
+    if (!stream->init(m_mode, m_key)) {
+        return {};
+    }
+    return stream;
+}
+
+QString KeePass2RandomStream::errorString() const
+{
+    return m_error;
+}
 
-    return true;
+QSharedPointer<Botan::StreamCipher> KeePass2RandomStream::createCipher() const
+{
+    const auto algorithm = m_mode == SymmetricCipher::Salsa20 ? "Salsa20" : "ChaCha20";
+
+    try {
+        auto cipher = Botan::StreamCipher::create_or_throw(algorithm);
+        cipher->set_key(reinterpret_cast<const uint8_t*>(m_cipherKey.data()), m_cipherKey.size());
+        cipher->set_iv(reinterpret_cast<const uint8_t*>(m_iv.data()), m_iv.size());
+        return QSharedPointer<Botan::StreamCipher>(cipher.release());
+    } catch (std::exception& e) {
+        qWarning("KeePass2RandomStream: Could not create %s cipher: %s", algorithm, e.what());
+        return {};
+    }
 }
@@ -18,8 +18,15 @@
 #ifndef KEEPASSX_KEEPASS2RANDOMSTREAM_H
 #define KEEPASSX_KEEPASS2RANDOMSTREAM_H
 
+#include <QSharedPointer>
+
 #include "crypto/SymmetricCipher.h"
 
+namespace Botan
+{
+    class StreamCipher;
+}
+
 class KeePass2RandomStream
 {
 public:
@@ -29,14 +36,24 @@ public:
     QByteArray randomBytes(int size, bool* ok);
     QByteArray process(const QByteArray& data, bool* ok);
     Q_REQUIRED_RESULT bool processInPlace(QByteArray& data);
+    Q_REQUIRED_RESULT bool skip(int size);
+    quint64 position() const;
+    Q_REQUIRED_RESULT bool processAt(QByteArray& data, quint64 position) const;
+    QSharedPointer<const KeePass2RandomStream> clone() const;
     QString errorString() const;
 
 private:
-    bool loadBlock();
+    QSharedPointer<Botan::StreamCipher> createCipher() const;
+
+    SymmetricCipher::Mode m_mode = SymmetricCipher::InvalidMode;
+    QByteArray m_key;
+    QByteArray m_cipherKey;
+    QByteArray m_iv;
+    QSharedPointer<Botan::StreamCipher> m_cipher;
+    quint64 m_position = 0;
+    QString m_error;
 
-    SymmetricCipher m_cipher;
-    QByteArray m_buffer;
-    int m_offset = 0;
+    Q_DISABLE_COPY(KeePass2RandomStream)
 };
 
 #endif // KEEPASSX_KEEPASS2RANDOMSTREAM_H
@@ -43,6 +43,7 @@
 #include "gui/EntryPreviewWidget.h"
 #include "gui/FileDialog.h"
 #include "gui/GuiTools.h"
+#include "gui/Icons.h"
 #include "gui/MainWindow.h"
 #include "gui/MessageBox.h"
 #include "gui/TotpDialog.h"
@@ -220,6 +221,8 @@ DatabaseWidget::DatabaseWidget(QSharedPointer<Database> db, QWidget* parent)
     // clang-format on
 
     connectDatabaseSignals();
+    // Derive the key for the next save in the background to keep saving fast
+    m_db->setPrecomputeNextKey(true);
 
     m_blockAutoSave = false;
 
@@ -463,6 +466,8 @@ void DatabaseWidget::replaceDatabase(QSharedPointer<Database> db)
     auto oldDb = m_db;
     m_db = std::move(db);
     connectDatabaseSignals();
+    m_db->setPrecomputeNextKey(true);
+    Icons::preloadCustomIcons(m_db);
     m_groupView->changeDatabase(m_db);
     m_tagView->setDatabase(m_db);
     m_remoteSettings->setDatabase(m_db);
@@ -25,8 +25,10 @@
 #include <QPainter>
 
 #include "config-keepassx.h"
+#include "core/AsyncTask.h"
 #include "core/Config.h"
 #include "core/Database.h"
+#include "core/Metadata.h"
 #include "gui/DatabaseIcons.h"
 #include "gui/MainWindow.h"
 #include "gui/osutils/OSUtils.h"
@@ -48,6 +50,29 @@ private:
     QColor m_overrideColor;
 };
 
+namespace
+{
+    // Memory budget of the custom icon cache of each database, in KiB
+    const int CUSTOM_ICON_IMAGE_CACHE_SIZE = 32 * 1024;
+    const int CUSTOM_ICON_PIXMAP_CACHE_SIZE = 8 * 1024;
+
+    // Custom icons are decoded once at this resolution and scaled down from there
+    QImage decodeCustomIcon(const QByteArray& data)
+    {
+        return QImage::fromData(data).scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    }
+
+    int imageCost(const QImage& image)
+    {
+        return qMax(1, image.bytesPerLine() * image.height() / 1024);
+    }
+
+    int pixmapCost(const QPixmap& pixmap)
+    {
+        return qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+    }
+} // namespace
+
 Icons* Icons::m_instance(nullptr);
 
 Icons::Icons() = default;
@@ -219,14 +244,38 @@ Icons* Icons::instance()
 }
 
 QPixmap Icons::customIconPixmap(const Database* db, const QUuid& uuid, IconSize size)
+{
+    return customIconPixmap(db, uuid, size, false);
+}
+
+QPixmap Icons::customIconPixmap(const Database* db, const QUuid& uuid, IconSize size, bool expired)
 {
     if (!db->metadata()->hasCustomIcon(uuid)) {
         return {};
     }
+
+    const int pixelSize = databaseIcons()->iconSize(size);
+    const auto key = QString("%1-%2-%3").arg(uuid.toString()).arg(pixelSize).arg(expired);
+    auto* cache = instance()->customIconCache(db);
+    if (auto* pixmap = cache->pixmaps.object(key)) {
+        return *pixmap;
+    }
+
+    QImage image;
+    if (auto* cachedImage = cache->images.object(uuid)) {
+        image = *cachedImage;
+    } else {
+        image = decodeCustomIcon(db->metadata()->customIcon(uuid).data);
+        cache->images.insert(uuid, new QImage(image), imageCost(image));
+    }
+
     // Generate QIcon with pre-baked resolutions
-    auto icon = QImage::fromData(db->metadata()->customIcon(uuid).data);
-    auto basePixmap = QPixmap::fromImage(icon.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-    return QIcon(basePixmap).pixmap(databaseIcons()->iconSize(size));
+    auto pixmap = QIcon(QPixmap::fromImage(image)).pixmap(pixelSize);
+    if (expired) {
+        pixmap = databaseIcons()->applyBadge(pixmap, DatabaseIcons::Badges::Expired);
+    }
+    cache->pixmaps.insert(key, new QPixmap(pixmap), pixmapCost(pixmap));
+    return pixmap;
 }
 
 QHash<QUuid, QPixmap> Icons::customIconsPixmaps(const Database* db, IconSize size)
@@ -242,13 +291,13 @@ QHash<QUuid, QPixmap> Icons::customIconsPixmaps(const Database* db, IconSize siz
 
 QPixmap Icons::entryIconPixmap(const Entry* entry, IconSize size)
 {
+    if (!entry->iconUuid().isNull() && entry->database()) {
+        return Icons::customIconPixmap(entry->database(), entry->iconUuid(), size, entry->isExpired());
+    }
+
     QPixmap icon(size, size);
     if (entry->iconUuid().isNull()) {
         icon = databaseIcons()->icon(entry->iconNumber(), size);
-    } else {
-        if (entry->database()) {
-            icon = Icons::customIconPixmap(entry->database(), entry->iconUuid(), size);
-        }
     }
 
     if (entry->isExpired()) {
@@ -260,13 +309,15 @@ QPixmap Icons::entryIconPixmap(const Entry* entry, IconSize size)
 
 QPixmap Icons::groupIconPixmap(const Group* group, IconSize size)
 {
+    if (!group->iconUuid().isNull() && group->database() && group->isExpired()) {
+        return Icons::customIconPixmap(group->database(), group->iconUuid(), size, true);
+    }
+
     QPixmap icon(size, size);
     if (group->iconUuid().isNull()) {
         icon = databaseIcons()->icon(group->iconNumber(), size);
-    } else {
-        if (group->database()) {
-            icon = Icons::customIconPixmap(group->database(), group->iconUuid(), size);
-        }
+    } else if (group->database()) {
+        icon = Icons::customIconPixmap(group->database(), group->iconUuid(), size);
     }
 
     if (group->isExpired()) {
@@ -281,6 +332,77 @@ QPixmap Icons::groupIconPixmap(const Group* group, IconSize size)
     return icon;
 }
 
+/**
+ * Decode the custom icons of a database in the background,
+ * so they don't have to be decoded while painting the views.
+ */
+void Icons::preloadCustomIcons(const QSharedPointer<Database>& db)
+{
+    QHash<QUuid, QByteArray> iconData;
+    for (const auto& uuid : db->metadata()->customIconsOrder()) {
+        iconData.insert(uuid, db->metadata()->customIcon(uuid).data);
+    }
+    if (iconData.isEmpty()) {
+        return;
+    }
+
+    const Database* database = db.data();
+    AsyncTask::runThenCallback(
+        [iconData] {
+            QHash<QUuid, QImage> images;
+            for (auto it = iconData.constBegin(); it != iconData.constEnd(); ++it) {
+                images.insert(it.key(), decodeCustomIcon(it.value()));
+            }
+            return images;
+        },
+        db.data(),
+        [database, iconData](const QHash<QUuid, QImage>& images) {
+            auto* cache = instance()->customIconCache(database);
+            for (auto it = images.constBegin(); it != images.constEnd(); ++it) {
+                // Skip icons that were decoded meanwhile or have changed since
+                const auto& uuid = it.key();
+                if (cache->images.contains(uuid) || !database->metadata()->hasCustomIcon(uuid)
+                    || database->metadata()->customIcon(uuid).data != iconData.value(uuid)) {
+                    continue;
+                }
+                cache->images.insert(uuid, new QImage(it.value()), imageCost(it.value()));
+            }
+        });
+}
+
+Icons::CustomIconCache* Icons::customIconCache(const Database* db)
+{
+    auto cache = m_customIconCaches.value(db);
+    if (!cache) {
+        cache.reset(new CustomIconCache());
+        cache->images.setMaxCost(CUSTOM_ICON_IMAGE_CACHE_SIZE);
+        cache->pixmaps.setMaxCost(CUSTOM_ICON_PIXMAP_CACHE_SIZE);
+        m_customIconCaches.insert(db, cache);
+
+        auto removeIcon = [db](const QUuid& uuid) { icons()->removeCustomIcon(db, uuid); };
+        QObject::connect(db->metadata(), &Metadata::customIconAdded, removeIcon);
+        QObject::connect(db->metadata(), &Metadata::customIconRemoved, removeIcon);
+        QObject::connect(db, &QObject::destroyed, [db] { icons()->m_customIconCaches.remove(db); });
+    }
+    return cache.data();
+}
+
+void Icons::removeCustomIcon(const Database* db, const QUuid& uuid)
+{
+    auto cache = m_customIconCaches.value(db);
+    if (!cache) {
+        return;
+    }
+
+    cache->images.remove(uuid);
+    const auto prefix = uuid.toString();
+    for (const auto& key : cache->pixmaps.keys()) {
+        if (key.startsWith(prefix)) {
+            cache->pixmaps.remove(key);
+        }
+    }
+}
+
 QString Icons::imageFormatsFilter()
 {
     const QList<QByteArray> formats = QImageReader::supportedImageFormats();
@@ -19,6 +19,7 @@
 #ifndef KEEPASSX_ICONS_H
 #define KEEPASSX_ICONS_H
 
+#include <QCache>
 #include <QIcon>
 
 #include <core/Database.h>
@@ -38,6 +39,7 @@ public:
     static QHash<QUuid, QPixmap> customIconsPixmaps(const Database* db, IconSize size = IconSize::Default);
     static QPixmap entryIconPixmap(const Entry* entry, IconSize size = IconSize::Default);
     static QPixmap groupIconPixmap(const Group* group, IconSize size = IconSize::Default);
+    static void preloadCustomIcons(const QSharedPointer<Database>& db);
 
     static QByteArray saveToBytes(const QImage& image);
     static QString imageFormatsFilter();
@@ -47,9 +49,21 @@ public:
 private:
     Icons();
 
+    // Decoded custom icons of a database, and the pixmaps made from them
+    struct CustomIconCache
+    {
+        QCache<QUuid, QImage> images;
+        QCache<QString, QPixmap> pixmaps;
+    };
+
+    static QPixmap customIconPixmap(const Database* db, const QUuid& uuid, IconSize size, bool expired);
+    CustomIconCache* customIconCache(const Database* db);
+    void removeCustomIcon(const Database* db, const QUuid& uuid);
+
     static Icons* m_instance;
 
     QHash<QString, QIcon> m_iconCache;
+    QHash<const Database*, QSharedPointer<CustomIconCache>> m_customIconCaches;
 
     Q_DISABLE_COPY(Icons)
 };
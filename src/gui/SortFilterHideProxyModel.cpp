@@ -45,6 +45,14 @@ bool SortFilterHideProxyModel::filterAcceptsColumn(int sourceColumn, const QMode
 
 bool SortFilterHideProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
 {
+    const auto leftKey = sourceModel()->data(left, CollationKeyRole);
+    if (leftKey.canConvert<CollationKey>()) {
+        const auto rightKey = sourceModel()->data(right, CollationKeyRole);
+        if (rightKey.canConvert<CollationKey>()) {
+            return leftKey.value<CollationKey>().key->compare(*rightKey.value<CollationKey>().key) < 0;
+        }
+    }
+
     auto leftData = sourceModel()->data(left, sortRole());
     auto rightData = sourceModel()->data(right, sortRole());
     if (leftData.type() == QVariant::String) {
@@ -20,13 +20,29 @@
 
 #include <QBitArray>
 #include <QCollator>
+#include <QSharedPointer>
 #include <QSortFilterProxyModel>
 
+/**
+ * Precomputed collation key of a string, see SortFilterHideProxyModel::CollationKeyRole.
+ * Keys are only comparable when they were made by collators with the same settings.
+ */
+struct CollationKey
+{
+    QSharedPointer<const QCollatorSortKey> key;
+};
+
+Q_DECLARE_METATYPE(CollationKey)
+
 class SortFilterHideProxyModel : public QSortFilterProxyModel
 {
     Q_OBJECT
 
 public:
+    // Source models can return a CollationKey for this role, made by a numeric mode
+    // collator, to spare collating the sort strings on every comparison
+    static const int CollationKeyRole = Qt::UserRole + 1;
+
     explicit SortFilterHideProxyModel(QObject* parent = nullptr);
     Qt::DropActions supportedDragActions() const override;
     void hideColumn(int column, bool hide);
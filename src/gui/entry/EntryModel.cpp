@@ -21,6 +21,7 @@
 #include <QMimeData>
 #include <QPalette>
 
+#include "core/Database.h"
 #include "core/Entry.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
@@ -32,12 +33,28 @@
 #include "gui/osutils/macutils/MacUtils.h"
 #endif
 
+namespace
+{
+    // Columns whose sort data only depends on one default attribute of the entry
+    const QList<QPair<int, QString>> CollationKeyColumns = {
+        {EntryModel::Title, EntryAttributes::TitleKey},
+        {EntryModel::Username, EntryAttributes::UserNameKey},
+        {EntryModel::Password, EntryAttributes::PasswordKey},
+        {EntryModel::Url, EntryAttributes::URLKey},
+        {EntryModel::Notes, EntryAttributes::NotesKey},
+    };
+} // namespace
+
 EntryModel::EntryModel(QObject* parent)
     : QAbstractTableModel(parent)
     , m_group(nullptr)
+    , m_merging(false)
     , HiddenContentDisplay(QString("\u25cf").repeated(6))
     , DateFormat(Qt::DefaultLocaleShortDate)
 {
+    // Must match the collator of SortFilterHideProxyModel
+    m_collator.setNumericMode(true);
+
     connect(config(), &Config::changed, this, &EntryModel::onConfigChanged);
 }
 
@@ -62,7 +79,11 @@ void EntryModel::setGroup(Group* group)
         return;
     }
 
-    beginResetModel();
+    // A merge in progress has already begun a reset
+    if (!m_merging) {
+        beginResetModel();
+    }
+    m_merging = false;
 
     severConnections();
 
@@ -70,6 +91,7 @@ void EntryModel::setGroup(Group* group)
     m_allGroups.clear();
     m_entries = group->entries();
     m_orgEntries.clear();
+    m_collationKeys.clear();
 
     makeConnections(group);
 
@@ -78,7 +100,11 @@ void EntryModel::setGroup(Group* group)
 
 void EntryModel::setEntries(const QList<Entry*>& entries)
 {
-    beginResetModel();
+    // A merge in progress has already begun a reset
+    if (!m_merging) {
+        beginResetModel();
+    }
+    m_merging = false;
 
     severConnections();
 
@@ -86,6 +112,7 @@ void EntryModel::setEntries(const QList<Entry*>& entries)
     m_allGroups.clear();
     m_entries = entries;
     m_orgEntries = entries;
+    m_collationKeys.clear();
 
     for (const auto entry : asConst(m_entries)) {
         if (entry->group()) {
@@ -272,6 +299,8 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             // Role for sorting
             return data(index, Qt::DisplayRole);
         }
+    } else if (role == SortFilterHideProxyModel::CollationKeyRole) {
+        return collationKey(index);
     } else if (role == Qt::DecorationRole) {
         switch (index.column()) {
         case ParentGroup:
@@ -507,6 +536,13 @@ void EntryModel::entryAboutToAdd(Entry* entry)
         return;
     }
 
+    if (m_merging) {
+        if (!m_group) {
+            m_entries.append(entry);
+        }
+        return;
+    }
+
     beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
     if (!m_group) {
         m_entries.append(entry);
@@ -515,7 +551,7 @@ void EntryModel::entryAboutToAdd(Entry* entry)
 
 void EntryModel::entryAdded(Entry* entry)
 {
-    if (!m_group && !m_orgEntries.contains(entry)) {
+    if (m_merging || (!m_group && !m_orgEntries.contains(entry))) {
         return;
     }
 
@@ -527,6 +563,15 @@ void EntryModel::entryAdded(Entry* entry)
 
 void EntryModel::entryAboutToRemove(Entry* entry)
 {
+    if (m_merging) {
+        // Search results are not recomputed after the merge, so deleted entries must go now
+        if (!m_group) {
+            m_entries.removeAll(entry);
+        }
+        return;
+    }
+
+    removeCollationKeys(entry);
     beginRemoveRows(QModelIndex(), m_entries.indexOf(entry), m_entries.indexOf(entry));
     if (!m_group) {
         m_entries.removeAll(entry);
@@ -535,6 +580,10 @@ void EntryModel::entryAboutToRemove(Entry* entry)
 
 void EntryModel::entryRemoved()
 {
+    if (m_merging) {
+        return;
+    }
+
     if (m_group) {
         m_entries = m_group->entries();
     }
@@ -543,6 +592,10 @@ void EntryModel::entryRemoved()
 
 void EntryModel::entryAboutToMoveUp(int row)
 {
+    if (m_merging) {
+        return;
+    }
+
     beginMoveRows(QModelIndex(), row, row, QModelIndex(), row - 1);
     if (m_group) {
         m_entries.move(row, row - 1);
@@ -551,6 +604,10 @@ void EntryModel::entryAboutToMoveUp(int row)
 
 void EntryModel::entryMovedUp()
 {
+    if (m_merging) {
+        return;
+    }
+
     if (m_group) {
         m_entries = m_group->entries();
     }
@@ -559,6 +616,10 @@ void EntryModel::entryMovedUp()
 
 void EntryModel::entryAboutToMoveDown(int row)
 {
+    if (m_merging) {
+        return;
+    }
+
     beginMoveRows(QModelIndex(), row, row, QModelIndex(), row + 2);
     if (m_group) {
         m_entries.move(row, row + 1);
@@ -567,6 +628,10 @@ void EntryModel::entryAboutToMoveDown(int row)
 
 void EntryModel::entryMovedDown()
 {
+    if (m_merging) {
+        return;
+    }
+
     if (m_group) {
         m_entries = m_group->entries();
     }
@@ -575,12 +640,43 @@ void EntryModel::entryMovedDown()
 
 void EntryModel::entryDataChanged(Entry* entry)
 {
+    if (m_merging) {
+        return;
+    }
+
+    removeCollationKeys(entry);
+
     int row = m_entries.indexOf(entry);
     emit dataChanged(index(row, 0), index(row, columnCount() - 1));
 }
 
+void EntryModel::aboutToMerge()
+{
+    // A merge can add, remove and change many entries, reset once instead of row by row
+    beginResetModel();
+    m_merging = true;
+}
+
+void EntryModel::merged()
+{
+    if (!m_merging) {
+        return;
+    }
+
+    if (m_group) {
+        m_entries = m_group->entries();
+    }
+    // Entries may have been deleted and others allocated at the same address
+    m_collationKeys.clear();
+    m_merging = false;
+    endResetModel();
+}
+
 void EntryModel::onConfigChanged(Config::ConfigKey key)
 {
+    // Displayed values, which are also used for sorting, can depend on the configuration
+    m_collationKeys.clear();
+
     switch (key) {
     case Config::GUI_HideUsernames:
         emit dataChanged(index(0, Username), index(rowCount() - 1, Username), {Qt::DisplayRole});
@@ -593,6 +689,45 @@ void EntryModel::onConfigChanged(Config::ConfigKey key)
     }
 }
 
+/**
+ * Collation key of the sort data of an index, cached until the entry changes.
+ * Returns nothing for columns whose sort data can change without the entry changing.
+ */
+QVariant EntryModel::collationKey(const QModelIndex& index) const
+{
+    const Entry* entry = entryFromIndex(index);
+    const int column = index.column();
+
+    for (const auto& cachedColumn : CollationKeyColumns) {
+        if (cachedColumn.first != column) {
+            continue;
+        }
+
+        // Placeholders and references can resolve differently without this entry changing
+        if (entry->attributes()->value(cachedColumn.second).contains('{')) {
+            return {};
+        }
+
+        const auto cacheKey = qMakePair(entry, column);
+        auto it = m_collationKeys.constFind(cacheKey);
+        if (it == m_collationKeys.constEnd()) {
+            const auto sortData = data(index, Qt::UserRole).toString();
+            CollationKey key{QSharedPointer<const QCollatorSortKey>::create(m_collator.sortKey(sortData))};
+            it = m_collationKeys.insert(cacheKey, key);
+        }
+        return QVariant::fromValue(it.value());
+    }
+
+    return {};
+}
+
+void EntryModel::removeCollationKeys(const Entry* entry)
+{
+    for (const auto& cachedColumn : CollationKeyColumns) {
+        m_collationKeys.remove(qMakePair(entry, cachedColumn.first));
+    }
+}
+
 void EntryModel::severConnections()
 {
     if (m_group) {
@@ -602,6 +737,13 @@ void EntryModel::severConnections()
     for (const Group* group : asConst(m_allGroups)) {
         disconnect(group, nullptr, this, nullptr);
     }
+
+    for (const auto& db : asConst(m_databases)) {
+        if (db) {
+            disconnect(db.data(), nullptr, this, nullptr);
+        }
+    }
+    m_databases.clear();
 }
 
 void EntryModel::makeConnections(const Group* group)
@@ -615,6 +757,13 @@ void EntryModel::makeConnections(const Group* group)
     connect(group, SIGNAL(entryAboutToMoveDown(int)), SLOT(entryAboutToMoveDown(int)));
     connect(group, SIGNAL(entryMovedDown()), SLOT(entryMovedDown()));
     connect(group, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
+
+    const Database* db = group->database();
+    if (db && !m_databases.contains(db)) {
+        m_databases.append(db);
+        connect(db, SIGNAL(aboutToMerge()), SLOT(aboutToMerge()));
+        connect(db, SIGNAL(merged()), SLOT(merged()));
+    }
 }
 void EntryModel::setBackgroundColorVisible(bool visible)
 {
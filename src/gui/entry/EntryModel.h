@@ -19,11 +19,15 @@
 #define KEEPASSX_ENTRYMODEL_H
 
 #include <QAbstractTableModel>
+#include <QCollator>
 #include <QPixmap>
+#include <QPointer>
 #include <QSet>
 
 #include "core/Config.h"
+#include "gui/SortFilterHideProxyModel.h"
 
+class Database;
 class Entry;
 class Group;
 
@@ -80,18 +84,26 @@ private slots:
     void entryAboutToMoveDown(int row);
     void entryMovedDown();
     void entryDataChanged(Entry* entry);
+    void aboutToMerge();
+    void merged();
 
     void onConfigChanged(Config::ConfigKey key);
 
 private:
     void severConnections();
     void makeConnections(const Group* group);
+    QVariant collationKey(const QModelIndex& index) const;
+    void removeCollationKeys(const Entry* entry);
 
     bool m_backgroundColorVisible = true;
     Group* m_group;
     QList<Entry*> m_entries;
     QList<Entry*> m_orgEntries;
     QSet<const Group*> m_allGroups;
+    QList<QPointer<const Database>> m_databases;
+    bool m_merging;
+    QCollator m_collator;
+    mutable QHash<QPair<const Entry*, int>, CollationKey> m_collationKeys;
 
     const QString HiddenContentDisplay;
     const Qt::DateFormat DateFormat;
@@ -30,13 +30,18 @@
 GroupModel::GroupModel(Database* db, QObject* parent)
     : QAbstractItemModel(parent)
     , m_db(nullptr)
+    , m_merging(false)
 {
     changeDatabase(db);
 }
 
 void GroupModel::changeDatabase(Database* newDb)
 {
-    beginResetModel();
+    // A merge in progress has already begun a reset
+    if (!m_merging) {
+        beginResetModel();
+    }
+    m_merging = false;
 
     m_db = newDb;
 
@@ -48,6 +53,8 @@ void GroupModel::changeDatabase(Database* newDb)
     connect(m_db, SIGNAL(groupRemoved()), SLOT(groupRemoved()));
     connect(m_db, SIGNAL(groupAboutToMove(Group*,Group*,int)), SLOT(groupAboutToMove(Group*,Group*,int)));
     connect(m_db, SIGNAL(groupMoved()), SLOT(groupMoved()));
+    connect(m_db, SIGNAL(aboutToMerge()), SLOT(aboutToMerge()));
+    connect(m_db, SIGNAL(merged()), SLOT(merged()));
     // clang-format on
 
     endResetModel();
@@ -364,12 +371,20 @@ QMimeData* GroupModel::mimeData(const QModelIndexList& indexes) const
 
 void GroupModel::groupDataChanged(Group* group)
 {
+    if (m_merging) {
+        return;
+    }
+
     QModelIndex ix = index(group);
     emit dataChanged(ix, ix);
 }
 
 void GroupModel::groupAboutToRemove(Group* group)
 {
+    if (m_merging) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
     QModelIndex parentIndex = parent(group);
@@ -382,11 +397,19 @@ void GroupModel::groupAboutToRemove(Group* group)
 
 void GroupModel::groupRemoved()
 {
+    if (m_merging) {
+        return;
+    }
+
     endRemoveRows();
 }
 
 void GroupModel::groupAboutToAdd(Group* group, int index)
 {
+    if (m_merging) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
     QModelIndex parentIndex = parent(group);
@@ -396,11 +419,19 @@ void GroupModel::groupAboutToAdd(Group* group, int index)
 
 void GroupModel::groupAdded()
 {
+    if (m_merging) {
+        return;
+    }
+
     endInsertRows();
 }
 
 void GroupModel::groupAboutToMove(Group* group, Group* toGroup, int pos)
 {
+    if (m_merging) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
     QModelIndex oldParentIndex = parent(group);
@@ -419,9 +450,30 @@ void GroupModel::groupAboutToMove(Group* group, Group* toGroup, int pos)
 
 void GroupModel::groupMoved()
 {
+    if (m_merging) {
+        return;
+    }
+
     endMoveRows();
 }
 
+void GroupModel::aboutToMerge()
+{
+    // A merge can touch every group, reset once instead of updating row by row
+    beginResetModel();
+    m_merging = true;
+}
+
+void GroupModel::merged()
+{
+    if (!m_merging) {
+        return;
+    }
+
+    m_merging = false;
+    endResetModel();
+}
+
 void GroupModel::sortChildren(Group* rootGroup, bool reverse)
 {
     emit layoutAboutToBeChanged();
@@ -59,9 +59,12 @@ private slots:
     void groupAdded();
     void groupAboutToMove(Group* group, Group* toGroup, int pos);
     void groupMoved();
+    void aboutToMerge();
+    void merged();
 
 private:
     Database* m_db;
+    bool m_merging;
 };
 
 #endif // KEEPASSX_GROUPMODEL_H
@@ -39,6 +39,7 @@ GroupView::GroupView(Database* db, QWidget* parent)
     connect(this, SIGNAL(collapsed(QModelIndex)), SLOT(expandedChanged(QModelIndex)));
     connect(this, SIGNAL(clicked(QModelIndex)), SIGNAL(groupSelectionChanged()));
     connect(m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(syncExpandedState(QModelIndex,int,int)));
+    connect(m_model, SIGNAL(modelAboutToBeReset()), SLOT(modelAboutToBeReset()));
     connect(m_model, SIGNAL(modelReset()), SLOT(modelReset()));
     connect(selectionModel(), SIGNAL(currentChanged(QModelIndex,QModelIndex)), SIGNAL(groupSelectionChanged()));
     // clang-format on
@@ -185,8 +186,21 @@ void GroupView::setCurrentGroup(Group* group)
     }
 }
 
+void GroupView::modelAboutToBeReset()
+{
+    m_groupBeforeReset = currentGroup();
+}
+
 void GroupView::modelReset()
 {
-    recInitExpanded(m_model->groupFromIndex(m_model->index(0, 0)));
-    setCurrentIndex(m_model->index(0, 0));
+    Group* rootGroup = m_model->groupFromIndex(m_model->index(0, 0));
+    recInitExpanded(rootGroup);
+
+    // Keep the selection when the model was only reset for a merge
+    if (m_groupBeforeReset && m_groupBeforeReset->database() == rootGroup->database()) {
+        setCurrentIndex(m_model->index(m_groupBeforeReset));
+    } else {
+        setCurrentIndex(m_model->index(0, 0));
+    }
+    m_groupBeforeReset.clear();
 }
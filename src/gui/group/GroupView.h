@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_GROUPVIEW_H
 #define KEEPASSX_GROUPVIEW_H
 
+#include <QPointer>
 #include <QTreeView>
 
 class Database;
@@ -44,6 +45,7 @@ signals:
 private slots:
     void expandedChanged(const QModelIndex& index);
     void syncExpandedState(const QModelIndex& parent, int start, int end);
+    void modelAboutToBeReset();
     void modelReset();
     void contextMenuShortcutPressed();
     void selectPreviousGroup();
@@ -58,6 +60,7 @@ private:
 
     GroupModel* const m_model;
     bool m_updatingExpanded;
+    QPointer<Group> m_groupBeforeReset;
 };
 
 #endif // KEEPASSX_GROUPVIEW_H
@@ -18,7 +18,6 @@
 #include "ReportsWidgetHealthcheck.h"
 #include "ui_ReportsWidgetHealthcheck.h"
 
-#include "core/AsyncTask.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "core/PasswordHealth.h"
@@ -33,49 +32,6 @@
 
 namespace
 {
-    class Health
-    {
-    public:
-        struct Item
-        {
-            QPointer<Group> group;
-            QPointer<Entry> entry;
-            QSharedPointer<PasswordHealth> health;
-            bool exclude = false;
-
-            Item(Group* g, Entry* e, QSharedPointer<PasswordHealth> h)
-                : group(g)
-                , entry(e)
-                , health(h)
-                , exclude(e->excludeFromReports())
-            {
-            }
-
-            bool operator<(const Item& rhs) const
-            {
-                return health->score() < rhs.health->score();
-            }
-        };
-
-        explicit Health(QSharedPointer<Database>);
-
-        const QList<QSharedPointer<Item>>& items() const
-        {
-            return m_items;
-        }
-
-        bool anyExcludedEntries() const
-        {
-            return m_anyExcludedEntries;
-        }
-
-    private:
-        QSharedPointer<Database> m_db;
-        HealthChecker m_checker;
-        QList<QSharedPointer<Item>> m_items;
-        bool m_anyExcludedEntries = false;
-    };
-
     class ReportSortProxyModel : public QSortFilterProxyModel
     {
     public:
@@ -98,49 +54,12 @@ namespace
     };
 } // namespace
 
-Health::Health(QSharedPointer<Database> db)
-    : m_db(db)
-    , m_checker(db)
-{
-    for (auto group : db->rootGroup()->groupsRecursive(true)) {
-        // Skip recycle bin
-        if (group->isRecycled()) {
-            continue;
-        }
-
-        for (auto entry : group->entries()) {
-            if (entry->isRecycled()) {
-                continue;
-            }
-
-            // Skip entries with empty password
-            if (entry->password().isEmpty()) {
-                continue;
-            }
-
-            // Evaluate this entry
-            const auto item = QSharedPointer<Item>(new Item(group, entry, m_checker.evaluate(entry)));
-            if (item->exclude) {
-                m_anyExcludedEntries = true;
-            }
-
-            // Add entry if its password isn't at least "good"
-            if (item->health->quality() < PasswordHealth::Quality::Good) {
-                m_items.append(item);
-            }
-        }
-    }
-
-    // Sort the result so that the worst passwords (least score)
-    // are at the top
-    std::sort(m_items.begin(), m_items.end(), [](QSharedPointer<Item> x, QSharedPointer<Item> y) { return *x < *y; });
-}
-
 ReportsWidgetHealthcheck::ReportsWidgetHealthcheck(QWidget* parent)
     : QWidget(parent)
     , m_ui(new Ui::ReportsWidgetHealthcheck())
     , m_referencesModel(new QStandardItemModel(this))
     , m_modelProxy(new ReportSortProxyModel(this))
+    , m_healthEngine(new PasswordHealthEngine(this))
 {
     m_ui->setupUi(this);
 
@@ -154,6 +73,10 @@ ReportsWidgetHealthcheck::ReportsWidgetHealthcheck(QWidget* parent)
     connect(m_ui->healthcheckTableView, SIGNAL(doubleClicked(QModelIndex)), SLOT(emitEntryActivated(QModelIndex)));
     connect(m_ui->showExcluded, SIGNAL(stateChanged(int)), this, SLOT(calculateHealth()));
     connect(m_ui->showExpired, SIGNAL(stateChanged(int)), this, SLOT(calculateHealth()));
+    connect(m_healthEngine,
+            SIGNAL(entryEvaluated(Entry*, QSharedPointer<PasswordHealth>)),
+            SLOT(addEntryHealth(Entry*, QSharedPointer<PasswordHealth>)));
+    connect(m_healthEngine, SIGNAL(finished()), SLOT(healthCalculated()));
 
     new QShortcut(Qt::Key_Delete, this, SLOT(deleteSelectedEntries()));
 }
@@ -230,6 +153,7 @@ void ReportsWidgetHealthcheck::addHealthRow(QSharedPointer<PasswordHealth> healt
 
 void ReportsWidgetHealthcheck::loadSettings(QSharedPointer<Database> db)
 {
+    m_healthEngine->cancel();
     m_db = std::move(db);
     m_healthCalculated = false;
     m_referencesModel->clear();
@@ -254,37 +178,71 @@ void ReportsWidgetHealthcheck::showEvent(QShowEvent* event)
 void ReportsWidgetHealthcheck::calculateHealth()
 {
     m_referencesModel->clear();
+    m_rowToEntry.clear();
+    m_anyExcludedEntries = false;
 
-    // Perform the health check
-    const QScopedPointer<Health> health(AsyncTask::runAndWaitForFuture([this] { return new Health(m_db); }));
+    m_referencesModel->setHorizontalHeaderLabels(QStringList() << tr("") << tr("Title") << tr("Path") << tr("Score")
+                                                               << tr("Reason"));
+    m_ui->healthcheckTableView->sortByColumn(0, Qt::AscendingOrder);
 
-    // Display the entries
-    m_rowToEntry.clear();
-    for (const auto& item : health->items()) {
-        // Check if the entry should be displayed
-        if ((!m_ui->showExcluded->isChecked() && item->exclude)
-            || (!m_ui->showExpired->isChecked() && item->entry->isExpired())) {
+    QList<Entry*> entries;
+    for (auto group : m_db->rootGroup()->groupsRecursive(true)) {
+        // Skip recycle bin
+        if (group->isRecycled()) {
             continue;
         }
 
-        // Show the entry in the report
-        addHealthRow(item->health, item->group, item->entry, item->exclude);
+        for (auto entry : group->entries()) {
+            if (entry->isRecycled()) {
+                continue;
+            }
+
+            // Skip entries with empty password
+            if (entry->password().isEmpty()) {
+                continue;
+            }
+
+            entries << entry;
+        }
+    }
+
+    // Perform the health check, the rows are added as the results come in
+    m_healthEngine->start(m_db, entries);
+}
+
+void ReportsWidgetHealthcheck::addEntryHealth(Entry* entry, QSharedPointer<PasswordHealth> health)
+{
+    const bool exclude = entry->excludeFromReports();
+    if (exclude) {
+        m_anyExcludedEntries = true;
     }
 
+    // Add entry if its password isn't at least "good"
+    if (health->quality() >= PasswordHealth::Quality::Good) {
+        return;
+    }
+
+    // Check if the entry should be displayed
+    if ((!m_ui->showExcluded->isChecked() && exclude) || (!m_ui->showExpired->isChecked() && entry->isExpired())) {
+        return;
+    }
+
+    // Show the entry in the report
+    addHealthRow(health, entry->group(), entry, exclude);
+}
+
+void ReportsWidgetHealthcheck::healthCalculated()
+{
     // Set the table header
     if (m_referencesModel->rowCount() == 0) {
         m_referencesModel->setHorizontalHeaderLabels(QStringList() << tr("Congratulations, everything is healthy!"));
-    } else {
-        m_referencesModel->setHorizontalHeaderLabels(QStringList() << tr("") << tr("Title") << tr("Path") << tr("Score")
-                                                                   << tr("Reason"));
-        m_ui->healthcheckTableView->sortByColumn(0, Qt::AscendingOrder);
     }
 
     m_ui->healthcheckTableView->resizeColumnsToContents();
     m_ui->healthcheckTableView->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Fixed);
 
     // Only show the "show excluded" checkbox if there are any excluded entries in the database
-    m_ui->showExcluded->setVisible(health->anyExcludedEntries());
+    m_ui->showExcluded->setVisible(m_anyExcludedEntries);
 }
 
 void ReportsWidgetHealthcheck::emitEntryActivated(const QModelIndex& index)
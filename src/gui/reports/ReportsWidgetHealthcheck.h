@@ -25,6 +25,7 @@ class Database;
 class Entry;
 class Group;
 class PasswordHealth;
+class PasswordHealthEngine;
 class QSortFilterProxyModel;
 class QStandardItemModel;
 
@@ -55,6 +56,10 @@ public slots:
     void customMenuRequested(QPoint);
     void deleteSelectedEntries();
 
+private slots:
+    void addEntryHealth(Entry* entry, QSharedPointer<PasswordHealth> health);
+    void healthCalculated();
+
 private:
     void addHealthRow(QSharedPointer<PasswordHealth>, Group*, Entry*, bool excluded);
 
@@ -65,6 +70,8 @@ private:
     QScopedPointer<QSortFilterProxyModel> m_modelProxy;
     QSharedPointer<Database> m_db;
     QList<QPair<Group*, Entry*>> m_rowToEntry;
+    PasswordHealthEngine* m_healthEngine;
+    bool m_anyExcludedEntries = false;
 };
 
 #endif // KEEPASSXC_REPORTSWIDGETHEALTHCHECK_H
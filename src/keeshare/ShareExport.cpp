@@ -90,7 +90,8 @@ namespace
 
         auto key = QSharedPointer<CompositeKey>::create();
         key->addKey(QSharedPointer<PasswordKey>::create(reference.password));
-        targetDb->setKey(key);
+        // The key is transformed with a fresh seed when the database is written
+        targetDb->setKey(key, true, false, false);
 
         auto obsoleteRoot = targetDb->setRootGroup(targetRoot);
         delete obsoleteRoot;
@@ -22,6 +22,7 @@
 #include <QFuture>
 #include <QtConcurrent/qtconcurrentrun.h>
 
+#include <cstdio>
 #include <iostream>
 
 #ifdef Q_OS_WIN
@@ -41,8 +42,8 @@ NativeMessagingProxy::NativeMessagingProxy()
             &NativeMessagingProxy::transferStdinMessage,
             Qt::QueuedConnection);
 
-    setupStandardInput();
     setupLocalSocket();
+    setupStandardInput();
 }
 
 void NativeMessagingProxy::setupStandardInput()
@@ -57,34 +58,40 @@ void NativeMessagingProxy::setupStandardInput()
 #endif
 #endif
 
+    // Messages are read with blocking reads on a worker thread, so they are
+    // forwarded as soon as they arrive. A QSocketNotifier can't be used
+    // because it doesn't support standard input on Windows.
     QtConcurrent::run([this] {
-        while (std::cin.good()) {
-            if (std::cin.peek() != EOF) {
-                uint length = 0;
-                for (uint i = 0; i < sizeof(uint); ++i) {
-                    length |= getchar() << (i * 8);
-                }
-
-                QString msg;
-                msg.reserve(length);
-                for (uint i = 0; i < length; ++i) {
-                    msg.append(getchar());
-                }
-
-                if (msg.length() > 0) {
-                    emit stdinMessage(msg);
-                }
+        forever {
+            // Each message is prefixed with its length in native byte order
+            quint32 length = 0;
+            if (!readStandardInput(reinterpret_cast<char*>(&length), sizeof(length))
+                || length > static_cast<quint32>(BrowserShared::NATIVEMSG_MAX_LENGTH)) {
+                break;
+            }
+
+            QByteArray msg(static_cast<int>(length), Qt::Uninitialized);
+            if (!readStandardInput(msg.data(), msg.size())) {
+                break;
+            }
+
+            if (!msg.isEmpty()) {
+                emit stdinMessage(msg);
             }
-            QThread::msleep(100);
         }
         QCoreApplication::quit();
     });
 }
 
-void NativeMessagingProxy::transferStdinMessage(const QString& msg)
+bool NativeMessagingProxy::readStandardInput(char* data, int size)
+{
+    return std::fread(data, 1, size, stdin) == static_cast<size_t>(size);
+}
+
+void NativeMessagingProxy::transferStdinMessage(const QByteArray& msg)
 {
     if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->write(msg.toUtf8(), msg.length());
+        m_localSocket->write(msg);
         m_localSocket->flush();
     }
 }
@@ -108,12 +115,12 @@ void NativeMessagingProxy::transferSocketMessage()
 {
     auto msg = m_localSocket->readAll();
     if (!msg.isEmpty()) {
-        // Explicitly write the message length as 1 byte chunks
-        uint len = msg.size();
+        // Write the message length in native byte order
+        quint32 len = msg.size();
         std::cout.write(reinterpret_cast<char*>(&len), sizeof(len));
 
         // Write the message and flush the stream
-        std::cout << msg.toStdString() << std::flush;
+        std::cout.write(msg.constData(), msg.size()) << std::flush;
     }
 }
 
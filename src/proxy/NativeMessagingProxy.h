@@ -31,15 +31,16 @@ public:
     ~NativeMessagingProxy() override = default;
 
 signals:
-    void stdinMessage(QString msg);
+    void stdinMessage(const QByteArray& msg);
 
 public slots:
     void transferSocketMessage();
-    void transferStdinMessage(const QString& msg);
+    void transferStdinMessage(const QByteArray& msg);
     void socketDisconnected();
 
 private:
     void setupStandardInput();
+    static bool readStandardInput(char* data, int size);
     void setupLocalSocket();
 
 private:
@@ -18,6 +18,7 @@
 
 #include "SSHAgent.h"
 
+#include "core/AsyncTask.h"
 #include "core/Config.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
@@ -27,6 +28,7 @@
 #include <QFileInfo>
 #include <QLocalSocket>
 #include <QThread>
+#include <QtConcurrent>
 
 #ifdef Q_OS_WIN
 #include <QtEndian>
@@ -35,6 +37,34 @@
 
 Q_GLOBAL_STATIC(SSHAgent, s_sshAgent);
 
+namespace
+{
+    // A key configured on an entry, copied out of the database so it can be decrypted on a worker thread
+    struct EntryIdentity
+    {
+        KeeAgentSettings settings;
+        QString username;
+        QString password;
+        QString databasePath;
+        QByteArray attachmentData;
+        OpenSSHKey key;
+        bool opened = false;
+    };
+
+    void openEntryIdentity(EntryIdentity& identity)
+    {
+        EntryAttachments attachments;
+        if (identity.settings.selectedType() == "attachment") {
+            attachments.set(identity.settings.attachmentName(), identity.attachmentData);
+        }
+
+        identity.opened = identity.settings.toOpenSSHKey(
+            identity.username, identity.password, identity.databasePath, &attachments, identity.key, true);
+    }
+} // namespace
+
+SSHAgent::~SSHAgent() = default;
+
 SSHAgent* SSHAgent::instance()
 {
     return s_sshAgent;
@@ -159,40 +189,88 @@ bool SSHAgent::isAgentRunning() const
 
 bool SSHAgent::sendMessage(const QByteArray& in, QByteArray& out)
 {
-#ifdef Q_OS_WIN
-    if (usePageant() && !sendMessagePageant(in, out)) {
+    QList<QByteArray> responses;
+    if (!sendMessages({in}, responses)) {
         return false;
     }
-    if (useOpenSSH() && !sendMessageOpenSSH(in, out)) {
+
+    out = responses.value(0);
+    return true;
+}
+
+bool SSHAgent::sendMessages(const QList<QByteArray>& in, QList<QByteArray>& out)
+{
+#ifdef Q_OS_WIN
+    if (usePageant()) {
+        out.clear();
+        for (const auto& message : in) {
+            QByteArray response;
+            if (!sendMessagePageant(message, response)) {
+                return false;
+            }
+            out.append(response);
+        }
+    }
+    if (useOpenSSH() && !sendMessagesOpenSSH(in, out)) {
         return false;
     }
     return true;
 #else
-    return sendMessageOpenSSH(in, out);
+    return sendMessagesOpenSSH(in, out);
 #endif
 }
 
-bool SSHAgent::sendMessageOpenSSH(const QByteArray& in, QByteArray& out)
+/**
+ * Send messages to the agent over a connection that is kept open between calls.
+ * All messages are written before the responses are read, the agent answers
+ * them in order.
+ *
+ * @param in messages to send
+ * @param out responses, one per message
+ * @return true on success
+ */
+bool SSHAgent::sendMessagesOpenSSH(const QList<QByteArray>& in, QList<QByteArray>& out)
 {
-    QLocalSocket socket;
-    BinaryStream stream(&socket);
+    // The agent may have closed a connection we kept open, retry once on a fresh one
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = m_socket && m_socket->state() == QLocalSocket::ConnectedState
+                      && m_socket->serverName() == socketPath();
+        if (!reused) {
+            m_socket.reset(new QLocalSocket());
+            m_socket->connectToServer(socketPath());
+            if (!m_socket->waitForConnected(500)) {
+                m_socket.reset();
+                m_error = tr("Agent connection failed.");
+                return false;
+            }
+        }
 
-    socket.connectToServer(socketPath());
-    if (!socket.waitForConnected(500)) {
-        m_error = tr("Agent connection failed.");
-        return false;
-    }
+        BinaryStream stream(m_socket.data());
+        for (const auto& message : in) {
+            stream.writeString(message);
+        }
+        stream.flush();
+
+        out.clear();
+        bool ok = true;
+        for (int i = 0; ok && i < in.size(); ++i) {
+            QByteArray response;
+            ok = stream.readString(response);
+            out.append(response);
+        }
 
-    stream.writeString(in);
-    stream.flush();
+        if (ok) {
+            return true;
+        }
 
-    if (!stream.readString(out)) {
-        m_error = tr("Agent protocol error.");
-        return false;
+        m_socket.reset();
+        if (!reused) {
+            break;
+        }
     }
 
-    socket.close();
-    return true;
+    m_error = tr("Agent protocol error.");
+    return false;
 }
 
 #ifdef Q_OS_WIN
@@ -280,6 +358,16 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
         return false;
     }
 
+    QByteArray responseData;
+    if (!sendMessage(addIdentityRequest(key, settings), responseData)) {
+        return false;
+    }
+
+    return addIdentityResponse(responseData, key, settings, databaseUuid);
+}
+
+QByteArray SSHAgent::addIdentityRequest(OpenSSHKey& key, const KeeAgentSettings& settings)
+{
     QByteArray requestData;
     BinaryStream request(&requestData);
     bool isSecurityKey = key.type().startsWith("sk-");
@@ -305,11 +393,18 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
         request.writeString(securityKeyProvider());
     }
 
-    QByteArray responseData;
-    if (!sendMessage(requestData, responseData)) {
-        return false;
-    }
+    return requestData;
+}
 
+/**
+ * Handle the agent's response to an add identity request, remembering the key on success.
+ */
+bool SSHAgent::addIdentityResponse(const QByteArray& responseData,
+                                   const OpenSSHKey& key,
+                                   const KeeAgentSettings& settings,
+                                   const QUuid& databaseUuid)
+{
+    bool isSecurityKey = key.type().startsWith("sk-");
     if (responseData.length() < 1 || static_cast<quint8>(responseData[0]) != SSH_AGENT_SUCCESS) {
         m_error =
             tr("Agent refused this identity. Possible reasons include:") + "\n" + tr("The key has already been added.");
@@ -336,6 +431,54 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
     return true;
 }
 
+/**
+ * Add identities of a database to the SSH agent, sending all requests at once.
+ * Errors are only reported for keys that were not added before.
+ *
+ * @param identities keys and their settings
+ * @param databaseUuid database that owns the keys for remove-on-lock
+ */
+void SSHAgent::addIdentities(QList<QPair<OpenSSHKey, KeeAgentSettings>>& identities, const QUuid& databaseUuid)
+{
+    QList<QPair<OpenSSHKey, KeeAgentSettings>> pending;
+    QList<bool> knownKeys;
+    QList<QByteArray> requests;
+    for (auto& identity : identities) {
+        // Ignore keys owned by other databases like addIdentity() does, without an error
+        bool knownKey = m_addedKeys.contains(identity.first);
+        if (knownKey && m_addedKeys[identity.first].first != databaseUuid) {
+            continue;
+        }
+
+        requests.append(addIdentityRequest(identity.first, identity.second));
+        knownKeys.append(knownKey);
+        pending.append(identity);
+    }
+
+    if (requests.isEmpty()) {
+        return;
+    }
+
+    if (!isAgentRunning()) {
+        m_error = tr("No agent running, cannot add identity.");
+        emit error(m_error);
+        return;
+    }
+
+    QList<QByteArray> responses;
+    if (!sendMessages(requests, responses)) {
+        emit error(m_error);
+        return;
+    }
+
+    for (int i = 0; i < pending.size(); ++i) {
+        if (!addIdentityResponse(responses.value(i), pending[i].first, pending[i].second, databaseUuid)
+            && !knownKeys[i]) {
+            emit error(m_error);
+        }
+    }
+}
+
 /**
  * Remove an identity from the SSH agent.
  *
@@ -461,6 +604,8 @@ bool SSHAgent::checkIdentity(const OpenSSHKey& key, bool& loaded)
  */
 void SSHAgent::removeAllIdentities()
 {
+    m_pendingUnlocks.clear();
+
     auto it = m_addedKeys.begin();
     while (it != m_addedKeys.end()) {
         // Remove key if requested to remove on lock
@@ -492,6 +637,9 @@ void SSHAgent::databaseLocked(const QSharedPointer<Database>& db)
         return;
     }
 
+    // Keys still being decrypted for this database will not be added
+    m_pendingUnlocks.remove(db->uuid());
+
     auto it = m_addedKeys.begin();
     while (it != m_addedKeys.end()) {
         if (it.value().first != db->uuid()) {
@@ -514,31 +662,59 @@ void SSHAgent::databaseUnlocked(const QSharedPointer<Database>& db)
         return;
     }
 
-    for (auto entry : db->rootGroup()->entriesRecursive()) {
+    QList<EntryIdentity> identities;
+    db->rootGroup()->forEachEntryRecursive([&](Entry* entry) {
         if (entry->isRecycled()) {
-            continue;
+            return;
         }
 
-        KeeAgentSettings settings;
+        EntryIdentity identity;
 
-        if (!settings.fromEntry(entry)) {
-            continue;
+        if (!identity.settings.fromEntry(entry)) {
+            return;
         }
 
-        if (!settings.allowUseOfSshKey() || !settings.addAtDatabaseOpen()) {
-            continue;
+        if (!identity.settings.allowUseOfSshKey() || !identity.settings.addAtDatabaseOpen()) {
+            return;
         }
 
-        OpenSSHKey key;
-
-        if (!settings.toOpenSSHKey(entry, key, true)) {
-            continue;
+        identity.username = entry->username();
+        identity.password = entry->password();
+        identity.databasePath = db->filePath();
+        if (identity.settings.selectedType() == "attachment") {
+            identity.attachmentData = entry->attachments()->value(identity.settings.attachmentName());
         }
+        identities.append(identity);
+    });
 
-        // Add key to agent; ignore errors if we have previously added the key
-        bool known_key = m_addedKeys.contains(key);
-        if (!addIdentity(key, settings, db->uuid()) && !known_key) {
-            emit error(m_error);
-        }
+    if (identities.isEmpty()) {
+        return;
     }
+
+    // Decrypting keys can take seconds, do it in parallel without blocking the unlock
+    const auto databaseUuid = db->uuid();
+    const auto unlock = ++m_unlockCount;
+    m_pendingUnlocks.insert(databaseUuid, unlock);
+
+    AsyncTask::runThenCallback(
+        [identities]() mutable {
+            QtConcurrent::blockingMap(identities, openEntryIdentity);
+            return identities;
+        },
+        this,
+        [this, databaseUuid, unlock](const QList<EntryIdentity>& openedIdentities) {
+            // The database was locked in the meantime
+            if (m_pendingUnlocks.value(databaseUuid) != unlock) {
+                return;
+            }
+            m_pendingUnlocks.remove(databaseUuid);
+
+            QList<QPair<OpenSSHKey, KeeAgentSettings>> keys;
+            for (const auto& identity : openedIdentities) {
+                if (identity.opened) {
+                    keys.append(qMakePair(identity.key, identity.settings));
+                }
+            }
+            addIdentities(keys, databaseUuid);
+        });
 }
@@ -25,13 +25,14 @@
 
 class KeeAgentSettings;
 class Database;
+class QLocalSocket;
 
 class SSHAgent : public QObject
 {
     Q_OBJECT
 
 public:
-    ~SSHAgent() override = default;
+    ~SSHAgent() override;
     static SSHAgent* instance();
 
     bool isEnabled() const;
@@ -80,7 +81,8 @@ private:
     const quint8 SSH_AGENT_CONSTRAIN_EXTENSION = 255;
 
     bool sendMessage(const QByteArray& in, QByteArray& out);
-    bool sendMessageOpenSSH(const QByteArray& in, QByteArray& out);
+    bool sendMessages(const QList<QByteArray>& in, QList<QByteArray>& out);
+    bool sendMessagesOpenSSH(const QList<QByteArray>& in, QList<QByteArray>& out);
 #ifdef Q_OS_WIN
     bool sendMessagePageant(const QByteArray& in, QByteArray& out);
 
@@ -88,7 +90,17 @@ private:
     const quint32 AGENT_COPYDATA_ID = 0x804e50ba;
 #endif
 
+    QByteArray addIdentityRequest(OpenSSHKey& key, const KeeAgentSettings& settings);
+    bool addIdentityResponse(const QByteArray& response,
+                             const OpenSSHKey& key,
+                             const KeeAgentSettings& settings,
+                             const QUuid& databaseUuid);
+    void addIdentities(QList<QPair<OpenSSHKey, KeeAgentSettings>>& identities, const QUuid& databaseUuid);
+
     QHash<OpenSSHKey, QPair<QUuid, bool>> m_addedKeys;
+    QHash<QUuid, quint64> m_pendingUnlocks;
+    quint64 m_unlockCount = 0;
+    QScopedPointer<QLocalSocket> m_socket;
     QString m_error;
 };
 
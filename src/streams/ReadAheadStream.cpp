@@ -0,0 +1,210 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ReadAheadStream.h"
+
+#include <QThread>
+
+#include <functional>
+
+namespace
+{
+    class ReadAheadThread : public QThread
+    {
+    public:
+        explicit ReadAheadThread(std::function<void()> function)
+            : m_function(std::move(function))
+        {
+        }
+
+    protected:
+        void run() override
+        {
+            m_function();
+        }
+
+    private:
+        std::function<void()> m_function;
+    };
+} // namespace
+
+ReadAheadStream::ReadAheadStream(QIODevice* baseDevice)
+    : ReadAheadStream(baseDevice, 1024 * 1024, 4)
+{
+}
+
+ReadAheadStream::ReadAheadStream(QIODevice* baseDevice, qint64 chunkSize, int maxChunks)
+    : LayeredStream(baseDevice)
+    , m_chunkSize(chunkSize)
+    , m_maxChunks(maxChunks)
+    , m_finished(false)
+    , m_stopped(false)
+    , m_error(false)
+    , m_currentPos(0)
+{
+    Q_ASSERT(chunkSize > 0 && maxChunks > 0);
+}
+
+ReadAheadStream::~ReadAheadStream()
+{
+    close();
+}
+
+bool ReadAheadStream::open(QIODevice::OpenMode mode)
+{
+    if (mode & QIODevice::WriteOnly) {
+        qWarning("ReadAheadStream::open: Writing is not supported.");
+        return false;
+    }
+
+    if (!LayeredStream::open(mode)) {
+        return false;
+    }
+
+    m_chunks.clear();
+    m_current.clear();
+    m_currentPos = 0;
+    m_finished = false;
+    m_stopped = false;
+    m_error = false;
+    m_errorString.clear();
+
+    m_thread.reset(new ReadAheadThread([this] { readAhead(); }));
+    m_thread->start();
+    return true;
+}
+
+void ReadAheadStream::close()
+{
+    stop();
+    LayeredStream::close();
+}
+
+void ReadAheadStream::stop()
+{
+    if (!m_thread) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopped = true;
+        m_spaceAvailable.wakeAll();
+    }
+    m_thread->wait();
+    m_thread.reset();
+}
+
+/**
+ * Worker thread: read chunks from the base device until it is exhausted,
+ * fails, or the stream is closed.
+ */
+void ReadAheadStream::readAhead()
+{
+    while (true) {
+        QByteArray chunk(static_cast<int>(m_chunkSize), Qt::Uninitialized);
+        qint64 readResult = m_baseDevice->read(chunk.data(), m_chunkSize);
+
+        QMutexLocker locker(&m_mutex);
+        if (readResult <= 0) {
+            if (readResult < 0) {
+                m_error = true;
+                m_errorString = m_baseDevice->errorString();
+            }
+            m_finished = true;
+            m_chunkAvailable.wakeAll();
+            return;
+        }
+
+        chunk.resize(static_cast<int>(readResult));
+        while (m_chunks.size() >= m_maxChunks && !m_stopped) {
+            m_spaceAvailable.wait(&m_mutex);
+        }
+        if (m_stopped) {
+            m_finished = true;
+            m_chunkAvailable.wakeAll();
+            return;
+        }
+
+        m_chunks.enqueue(chunk);
+        m_chunkAvailable.wakeAll();
+    }
+}
+
+qint64 ReadAheadStream::readData(char* data, qint64 maxSize)
+{
+    qint64 bytesRead = 0;
+
+    while (bytesRead < maxSize) {
+        if (m_currentPos == m_current.size()) {
+            QMutexLocker locker(&m_mutex);
+            while (m_chunks.isEmpty() && !m_finished) {
+                m_chunkAvailable.wait(&m_mutex);
+            }
+            if (m_chunks.isEmpty()) {
+                // Only report an error once all data read before it has been consumed
+                if (m_error && bytesRead == 0) {
+                    setErrorString(m_errorString);
+                    return -1;
+                }
+                break;
+            }
+            m_current = m_chunks.dequeue();
+            m_currentPos = 0;
+            m_spaceAvailable.wakeAll();
+        }
+
+        const qint64 bytesToCopy = qMin(maxSize - bytesRead, static_cast<qint64>(m_current.size() - m_currentPos));
+        memcpy(data + bytesRead, m_current.constData() + m_currentPos, static_cast<size_t>(bytesToCopy));
+        bytesRead += bytesToCopy;
+        m_currentPos += static_cast<int>(bytesToCopy);
+    }
+
+    return bytesRead;
+}
+
+qint64 ReadAheadStream::writeData(const char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+bool ReadAheadStream::atEnd() const
+{
+    if (!isOpen()) {
+        return true;
+    }
+    if (m_currentPos < m_current.size()) {
+        return false;
+    }
+
+    // Does not block: data that is still being produced means "not at end"
+    QMutexLocker locker(&m_mutex);
+    return m_finished && m_chunks.isEmpty();
+}
+
+qint64 ReadAheadStream::bytesAvailable() const
+{
+    qint64 available = m_current.size() - m_currentPos;
+
+    QMutexLocker locker(&m_mutex);
+    for (const auto& chunk : m_chunks) {
+        available += chunk.size();
+    }
+    return available + LayeredStream::bytesAvailable();
+}
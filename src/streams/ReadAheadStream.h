@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_READAHEADSTREAM_H
+#define KEEPASSX_READAHEADSTREAM_H
+
+#include <QMutex>
+#include <QQueue>
+#include <QScopedPointer>
+#include <QWaitCondition>
+
+#include "streams/LayeredStream.h"
+
+class QThread;
+
+/**
+ * Read-only stream that reads its base device on a worker thread and hands
+ * the data over through a bounded queue of chunks.
+ *
+ * Placing one of these on top of each layer of a stream stack turns the
+ * stack into a pipeline in which every layer runs on its own thread. The
+ * base device must not be used by anyone else while this stream is open.
+ */
+class ReadAheadStream : public LayeredStream
+{
+    Q_OBJECT
+
+public:
+    explicit ReadAheadStream(QIODevice* baseDevice);
+    ReadAheadStream(QIODevice* baseDevice, qint64 chunkSize, int maxChunks);
+    ~ReadAheadStream() override;
+
+    bool open(QIODevice::OpenMode mode) override;
+    void close() override;
+    bool atEnd() const override;
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override;
+    qint64 writeData(const char* data, qint64 maxSize) override;
+
+private:
+    void readAhead();
+    void stop();
+
+    const qint64 m_chunkSize;
+    const int m_maxChunks;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_chunkAvailable;
+    QWaitCondition m_spaceAvailable;
+    QQueue<QByteArray> m_chunks;
+    bool m_finished;
+    bool m_stopped;
+    bool m_error;
+    QString m_errorString;
+
+    QByteArray m_current;
+    int m_currentPos;
+
+    QScopedPointer<QThread> m_thread;
+};
+
+#endif // KEEPASSX_READAHEADSTREAM_H
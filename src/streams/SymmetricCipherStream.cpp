@@ -18,10 +18,15 @@
 #include "SymmetricCipherStream.h"
 
 SymmetricCipherStream::SymmetricCipherStream(QIODevice* baseDevice)
+    : SymmetricCipherStream(baseDevice, 1024 * 1024)
+{
+}
+
+SymmetricCipherStream::SymmetricCipherStream(QIODevice* baseDevice, qint32 bufferSize)
     : LayeredStream(baseDevice)
     , m_cipher(new SymmetricCipher())
+    , m_bufferSize(bufferSize)
     , m_bufferPos(0)
-    , m_bufferFilling(false)
     , m_error(false)
     , m_isInitialized(false)
     , m_dataWritten(false)
@@ -51,8 +56,8 @@ bool SymmetricCipherStream::init(SymmetricCipher::Mode mode,
 void SymmetricCipherStream::resetInternalState()
 {
     m_buffer.clear();
+    m_pending.clear();
     m_bufferPos = 0;
-    m_bufferFilling = false;
     m_error = false;
     m_dataWritten = false;
     m_cipher->reset();
@@ -99,7 +104,7 @@ qint64 SymmetricCipherStream::readData(char* data, qint64 maxSize)
     qint64 offset = 0;
 
     while (bytesRemaining > 0) {
-        if ((m_bufferPos == m_buffer.size()) || m_bufferFilling) {
+        if (m_bufferPos == m_buffer.size()) {
             if (!readBlock()) {
                 if (m_error) {
                     return -1;
@@ -123,47 +128,65 @@ qint64 SymmetricCipherStream::readData(char* data, qint64 maxSize)
 
 bool SymmetricCipherStream::readBlock()
 {
-    QByteArray newData;
-
-    if (m_bufferFilling) {
-        newData.resize(blockSize() - m_buffer.size());
-    } else {
-        m_buffer.clear();
-        newData.resize(blockSize());
+    // Start with the ciphertext that was held back by the previous call and fill up to a whole chunk
+    const int pendingSize = m_pending.size();
+    m_buffer.reserve(bufferSize());
+    m_buffer.resize(bufferSize());
+    memcpy(m_buffer.data(), m_pending.constData(), pendingSize);
+    m_pending.clear();
+
+    int bufferFilled = pendingSize;
+    while (bufferFilled < m_buffer.size()) {
+        qint64 readResult = m_baseDevice->read(m_buffer.data() + bufferFilled, m_buffer.size() - bufferFilled);
+        if (readResult == -1) {
+            m_error = true;
+            setErrorString(m_baseDevice->errorString());
+            return false;
+        } else if (readResult == 0) {
+            break;
+        }
+        bufferFilled += readResult;
     }
 
-    int readResult = m_baseDevice->read(newData.data(), newData.size());
+    const bool atEnd = bufferFilled < m_buffer.size() || m_baseDevice->atEnd();
+    m_bufferPos = 0;
 
-    if (readResult == -1) {
-        m_error = true;
-        setErrorString(m_baseDevice->errorString());
-        return false;
-    } else {
-        m_buffer.append(newData.left(readResult));
+    if (m_streamCipher) {
+        m_buffer.resize(bufferFilled);
+        if (bufferFilled > 0 && !m_cipher->process(m_buffer)) {
+            m_error = true;
+            setErrorString(m_cipher->errorString());
+            return false;
+        }
+        return bufferFilled > 0;
     }
 
-    if (!m_streamCipher && m_buffer.size() != blockSize()) {
-        m_bufferFilling = true;
-        return false;
-    } else {
-        m_bufferPos = 0;
-        m_bufferFilling = false;
-
-        if (!m_streamCipher && m_baseDevice->atEnd()) {
-            if (!m_cipher->finish(m_buffer)) {
-                m_error = true;
-                setErrorString(m_cipher->errorString());
-                return false;
-            }
-        } else if (m_buffer.size() > 0) {
-            if (!m_cipher->process(m_buffer)) {
-                m_error = true;
-                setErrorString(m_cipher->errorString());
-                return false;
-            }
+    const int partialBlock = bufferFilled % blockSize();
+    if (atEnd && partialBlock == 0) {
+        m_buffer.resize(bufferFilled);
+        if (bufferFilled > 0 && !m_cipher->finish(m_buffer)) {
+            m_error = true;
+            setErrorString(m_cipher->errorString());
+            return false;
         }
         return m_buffer.size() > 0;
     }
+
+    // Keep the last complete block back until we know whether it has to be passed through finish()
+    // to strip the padding. A truncated trailing block can never be decrypted and is dropped.
+    int processSize = bufferFilled - partialBlock;
+    if (!atEnd) {
+        processSize -= blockSize();
+        m_pending = m_buffer.mid(processSize, bufferFilled - processSize);
+    }
+
+    m_buffer.resize(processSize);
+    if (processSize > 0 && !m_cipher->process(m_buffer)) {
+        m_error = true;
+        setErrorString(m_cipher->errorString());
+        return false;
+    }
+    return processSize > 0;
 }
 
 qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
@@ -175,18 +198,19 @@ qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
     }
 
     m_dataWritten = true;
+    m_buffer.reserve(bufferSize());
     qint64 bytesRemaining = maxSize;
     qint64 offset = 0;
 
     while (bytesRemaining > 0) {
-        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(blockSize() - m_buffer.size()));
+        int bytesToCopy = qMin(bytesRemaining, static_cast<qint64>(bufferSize() - m_buffer.size()));
 
         m_buffer.append(data + offset, bytesToCopy);
 
         offset += bytesToCopy;
         bytesRemaining -= bytesToCopy;
 
-        if (m_buffer.size() == blockSize()) {
+        if (m_buffer.size() == bufferSize()) {
             if (!writeBlock(false)) {
                 if (m_error) {
                     return -1;
@@ -202,16 +226,15 @@ qint64 SymmetricCipherStream::writeData(const char* data, qint64 maxSize)
 
 bool SymmetricCipherStream::writeBlock(bool lastBlock)
 {
-    Q_ASSERT(m_streamCipher || lastBlock || (m_buffer.size() == blockSize()));
+    Q_ASSERT(m_streamCipher || lastBlock || (m_buffer.size() == bufferSize()));
 
     if (lastBlock && !m_streamCipher) {
-        QByteArray end;
         if (!m_cipher->finish(m_buffer)) {
             m_error = true;
             setErrorString(m_cipher->errorString());
             return false;
         }
-    } else if (!m_cipher->process(m_buffer)) {
+    } else if (!m_buffer.isEmpty() && !m_cipher->process(m_buffer)) {
         m_error = true;
         setErrorString(m_cipher->errorString());
         return false;
@@ -222,7 +245,7 @@ bool SymmetricCipherStream::writeBlock(bool lastBlock)
         setErrorString(m_baseDevice->errorString());
         return false;
     } else {
-        m_buffer.clear();
+        m_buffer.resize(0);
         return true;
     }
 }
@@ -234,3 +257,14 @@ int SymmetricCipherStream::blockSize() const
     }
     return m_cipher->blockSize(m_cipher->mode());
 }
+
+/**
+ * Number of bytes that are passed to the cipher in one go. This is always a
+ * multiple of the cipher block size and at least two blocks, so that one block
+ * can be held back for the padding check of block ciphers.
+ */
+int SymmetricCipherStream::bufferSize() const
+{
+    const int size = blockSize();
+    return qMax(m_bufferSize - m_bufferSize % size, 2 * size);
+}
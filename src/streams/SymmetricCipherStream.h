@@ -29,7 +29,8 @@ class SymmetricCipherStream : public LayeredStream
     Q_OBJECT
 
 public:
-    SymmetricCipherStream(QIODevice* baseDevice);
+    explicit SymmetricCipherStream(QIODevice* baseDevice);
+    SymmetricCipherStream(QIODevice* baseDevice, qint32 bufferSize);
     ~SymmetricCipherStream() override;
     bool
     init(SymmetricCipher::Mode mode, SymmetricCipher::Direction direction, const QByteArray& key, const QByteArray& iv);
@@ -46,11 +47,13 @@ private:
     bool readBlock();
     bool writeBlock(bool lastBlock);
     int blockSize() const;
+    int bufferSize() const;
 
     const QScopedPointer<SymmetricCipher> m_cipher;
+    qint32 m_bufferSize;
     QByteArray m_buffer;
+    QByteArray m_pending;
     int m_bufferPos;
-    bool m_bufferFilling;
     bool m_error;
     bool m_isInitialized;
     bool m_dataWritten;
@@ -278,6 +278,73 @@ void TestAutoType::testGlobalAutoTypeRegExp()
     m_test->clearActions();
 }
 
+void TestAutoType::testGlobalAutoTypeMatcherUpdates()
+{
+    config()->set(Config::AutoTypeEntryTitleMatch, true);
+
+    QCOMPARE(m_entry3->autoTypeSequences("REGEX2"), QList<QString>() << "regex2");
+
+    // Changed associations are picked up by the cached matchers
+    auto association = m_entry3->autoTypeAssociations()->get(1);
+    association.window = "//^REGEX4$//";
+    m_entry3->autoTypeAssociations()->update(1, association);
+    QVERIFY(m_entry3->autoTypeSequences("REGEX2").isEmpty());
+    QCOMPARE(m_entry3->autoTypeSequences("REGEX4"), QList<QString>() << "regex2");
+
+    // So are changed titles, URLs and attributes used by placeholders
+    QCOMPARE(m_entry2->autoTypeSequences("An Entry Title!").size(), 1);
+    m_entry2->setTitle("other title");
+    QVERIFY(m_entry2->autoTypeSequences("An Entry Title!").isEmpty());
+    QCOMPARE(m_entry2->autoTypeSequences("Some other title").size(), 1);
+
+    m_entry5->setUrl("https://example.com/login");
+    QVERIFY(m_entry5->autoTypeSequences("Dummy - http://example.org/ - <My Browser>").isEmpty());
+    QCOMPARE(m_entry5->autoTypeSequences("Dummy - https://example.com/ - <My Browser>").size(), 1);
+
+    QCOMPARE(m_entry4->autoTypeSequences("AttrValueFirst"), QList<QString>() << "custom_attr_first");
+    m_entry4->attributes()->set("CustomAttrFirst", "ChangedValue", false);
+    QVERIFY(m_entry4->autoTypeSequences("AttrValueFirst").isEmpty());
+    QCOMPARE(m_entry4->autoTypeSequences("ChangedValue"), QList<QString>() << "custom_attr_first");
+
+    // The match settings passed in take precedence over the configuration
+    QVERIFY(m_entry2->autoTypeSequences("Some other title", false, false).isEmpty());
+}
+
+void TestAutoType::benchmarkGlobalAutoTypeMatching()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    config()->set(Config::AutoTypeEntryTitleMatch, true);
+
+    AutoTypeAssociations::Association association;
+    for (int i = 0; i < 20000; ++i) {
+        auto entry = new Entry();
+        entry->setGroup(m_group);
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setUrl(QString("https://site%1.example.com/login").arg(i));
+        association.window = QString("//^Window %1 - .*$//").arg(i);
+        association.sequence = QString("sequence%1").arg(i);
+        entry->autoTypeAssociations()->add(association);
+        association.window = QString("*Application %1*").arg(i);
+        entry->autoTypeAssociations()->add(association);
+    }
+
+    const auto entries = m_group->entriesRecursive();
+    const QString windowTitle("Window 12345 - Browser");
+    int matches = 0;
+    QBENCHMARK
+    {
+        matches = 0;
+        for (const auto entry : entries) {
+            matches += entry->autoTypeSequences(windowTitle, true, true).size();
+        }
+    }
+    QCOMPARE(matches, 1);
+}
+
 void TestAutoType::testAutoTypeResults()
 {
     QScopedPointer<Entry> entry(new Entry());
@@ -47,6 +47,8 @@ private slots:
     void testGlobalAutoTypeUrlSubdomainMatch();
     void testGlobalAutoTypeTitleMatchDisabled();
     void testGlobalAutoTypeRegExp();
+    void testGlobalAutoTypeMatcherUpdates();
+    void benchmarkGlobalAutoTypeMatching();
     void testAutoTypeResults();
     void testAutoTypeResults_data();
     void testAutoTypeSyntaxChecks();
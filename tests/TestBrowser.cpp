@@ -740,3 +740,57 @@ void TestBrowser::testRestrictBrowserKey()
     QCOMPARE(sorted[2]->url(), QString("https://example.com/2"));
     QCOMPARE(sorted[3]->url(), QString("https://example.com/0"));
 }
+
+void TestBrowser::testSearchEntriesIndexUpdates()
+{
+    auto db = QSharedPointer<Database>::create();
+    auto* root = db->rootGroup();
+
+    QStringList urls = {"https://github.com/login", "https://example.com", "https://www.keepassxc.org"};
+    auto entries = createEntries(urls, root);
+
+    browserSettings()->setMatchUrlScheme(false);
+    auto result = m_browserService->searchEntries(db, "https://github.com", "https://github.com");
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result[0], entries[0]);
+
+    // Changing the URL moves the entry to another domain
+    entries[1]->setUrl("https://gist.github.com");
+    result = m_browserService->searchEntries(db, "https://gist.github.com", "https://gist.github.com");
+    QCOMPARE(result.size(), 2);
+    QVERIFY(m_browserService->searchEntries(db, "https://example.com", "https://example.com").isEmpty());
+
+    // Additional URLs are indexed as well
+    entries[2]->attributes()->set(EntryAttributes::AdditionalUrlAttribute, "https://example.com");
+    result = m_browserService->searchEntries(db, "https://example.com", "https://example.com");
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result[0], entries[2]);
+
+    // New groups and entries are picked up
+    auto* group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setParent(root);
+    QStringList newUrls = {"https://github.com/new"};
+    auto newEntries = createEntries(newUrls, group);
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com");
+    QCOMPARE(result.size(), 2);
+    QCOMPARE(result[0], entries[0]);
+    QCOMPARE(result[1], newEntries[0]);
+
+    // Removed entries are dropped
+    delete entries[0];
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com");
+    QCOMPARE(result.size(), 1);
+    QCOMPARE(result[0], newEntries[0]);
+
+    // References are resolved at search time
+    auto* refEntry = new Entry();
+    refEntry->setUuid(QUuid::createUuid());
+    refEntry->setGroup(root);
+    refEntry->setUrl(QString("{REF:U@I:%1}").arg(newEntries[0]->uuidToHex()));
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com");
+    QCOMPARE(result.size(), 2);
+    newEntries[0]->setUrl("https://keepassxc.org");
+    result = m_browserService->searchEntries(db, "https://keepassxc.org", "https://keepassxc.org");
+    QCOMPARE(result.size(), 2);
+}
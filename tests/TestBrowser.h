@@ -50,6 +50,7 @@ private slots:
     void testBestMatchingCredentials();
     void testBestMatchingWithAdditionalURLs();
     void testRestrictBrowserKey();
+    void testSearchEntriesIndexUpdates();
 
 private:
     QList<Entry*> createEntries(QStringList& urls, Group* root) const;
@@ -43,6 +43,7 @@
 #include "cli/Export.h"
 #include "cli/Generate.h"
 #include "cli/Help.h"
+#include "cli/HibpIndex.h"
 #include "cli/Import.h"
 #include "cli/List.h"
 #include "cli/Merge.h"
@@ -51,12 +52,19 @@
 #include "cli/Remove.h"
 #include "cli/RemoveGroup.h"
 #include "cli/Search.h"
+#include "cli/Serve.h"
 #include "cli/Show.h"
 #include "cli/Utils.h"
 
 #include <QClipboard>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
 #include <QSignalSpy>
+#include <QTemporaryDir>
 #include <QTest>
+#include <QThread>
 #include <QtConcurrent>
 #include <zxcvbn.h>
 
@@ -237,6 +245,7 @@ void TestCli::testBatchCommands()
     QVERIFY(Commands::getCommand("export"));
     QVERIFY(Commands::getCommand("generate"));
     QVERIFY(Commands::getCommand("help"));
+    QVERIFY(Commands::getCommand("hibp-index"));
     QVERIFY(Commands::getCommand("import"));
     QVERIFY(Commands::getCommand("ls"));
     QVERIFY(Commands::getCommand("merge"));
@@ -247,8 +256,9 @@ void TestCli::testBatchCommands()
     QVERIFY(Commands::getCommand("rmdir"));
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(Commands::getCommand("search"));
+    QVERIFY(Commands::getCommand("serve"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 26);
+    QCOMPARE(Commands::getCommands().size(), 28);
 }
 
 void TestCli::testInteractiveCommands()
@@ -269,6 +279,7 @@ void TestCli::testInteractiveCommands()
     QVERIFY(Commands::getCommand("exit"));
     QVERIFY(Commands::getCommand("generate"));
     QVERIFY(Commands::getCommand("help"));
+    QVERIFY(Commands::getCommand("hibp-index"));
     QVERIFY(Commands::getCommand("ls"));
     QVERIFY(Commands::getCommand("merge"));
     QVERIFY(Commands::getCommand("mkdir"));
@@ -280,7 +291,7 @@ void TestCli::testInteractiveCommands()
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(Commands::getCommand("search"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 26);
+    QCOMPARE(Commands::getCommands().size(), 27);
 }
 
 void TestCli::testAdd()
@@ -448,6 +459,14 @@ void TestCli::testAnalyze()
     QVERIFY(output.contains("123"));
     m_stderr->readLine(); // Skip password prompt
     QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    setInput("a");
+    execCmd(analyzeCmd, {"analyze", "--weak", m_dbFile->fileName()});
+    output = m_stdout->readAll();
+    QVERIFY(output.contains("Password for 'Sample Entry' has a score of"));
+    QVERIFY(!output.contains("leaked"));
+    m_stderr->readLine(); // Skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
 }
 
 void TestCli::testAttachmentExport()
@@ -2057,6 +2076,142 @@ void TestCli::testSearch()
     QCOMPARE(m_stdout->readAll(), QByteArray("/Sample Entry\n/Homebanking/Subgroup/Subgroup Entry\n"));
 }
 
+namespace
+{
+    // Sends the requests to a serving CLI one by one, waiting for the server to come up first
+    QList<QJsonObject> serveRequests(const QString& socketPath, const QList<QByteArray>& requests)
+    {
+        QLocalSocket socket;
+        QElapsedTimer timer;
+        timer.start();
+        while (socket.state() != QLocalSocket::ConnectedState && timer.elapsed() < 10000) {
+            socket.connectToServer(socketPath);
+            if (!socket.waitForConnected(1000)) {
+                QThread::msleep(10);
+            }
+        }
+
+        QList<QJsonObject> responses;
+        for (const auto& request : requests) {
+            socket.write(request + "\n");
+            socket.waitForBytesWritten();
+            while (!socket.canReadLine() && socket.waitForReadyRead(10000)) {
+            }
+            if (!socket.canReadLine()) {
+                break;
+            }
+            responses << QJsonDocument::fromJson(socket.readLine()).object();
+        }
+        return responses;
+    }
+} // namespace
+
+void TestCli::testServe()
+{
+    Serve serveCmd;
+    QVERIFY(!serveCmd.name.isEmpty());
+    QVERIFY(serveCmd.getDescriptionLine().contains(serveCmd.name));
+
+    QTemporaryDir socketDir;
+    QVERIFY(socketDir.isValid());
+    const auto socketPath = socketDir.filePath("serve.socket");
+
+    const QList<QByteArray> requests = {
+        R"({"id":1,"command":"show","arguments":["-a","Password","/Sample Entry"]})",
+        R"({"id":2,"command":"search","arguments":["Sample"]})",
+        R"({"id":3,"command":"totp","arguments":["/Sample Entry"]})",
+        R"({"id":4,"command":"add","arguments":["-u","newuser","-p","/newuser-entry"],"stdin":"newpassword\n"})",
+        R"({"id":5,"command":"show","arguments":["-a","Password","/newuser-entry"]})",
+        R"({"id":6,"command":"show","arguments":["/doesnotexist"]})",
+        R"({"id":7,"command":"rm","arguments":["/Sample Entry"]})",
+        R"(not json)",
+        R"({"id":8,"command":"lock"})"};
+
+    auto future = QtConcurrent::run([socketPath, requests] { return serveRequests(socketPath, requests); });
+
+    setInput("a");
+    QCOMPARE(execCmd(serveCmd, {"serve", m_dbFile->fileName(), socketPath}), EXIT_SUCCESS);
+    QVERIFY(m_stdout->readAll().contains("Database locked."));
+
+    const auto responses = future.result();
+    QCOMPARE(responses.size(), requests.size());
+
+    QCOMPARE(responses[0]["id"].toInt(), 1);
+    QCOMPARE(responses[0]["exitCode"].toInt(), EXIT_SUCCESS);
+    QCOMPARE(responses[0]["stdout"].toString(), QString("Password\n"));
+    QCOMPARE(responses[0]["stderr"].toString(), QString());
+
+    QCOMPARE(responses[1]["stdout"].toString(), QString("/Sample Entry\n"));
+    QVERIFY(isTotp(responses[2]["stdout"].toString()));
+
+    QCOMPARE(responses[3]["exitCode"].toInt(), EXIT_SUCCESS);
+    QCOMPARE(responses[4]["stdout"].toString(), QString("newpassword\n"));
+
+    QCOMPARE(responses[5]["id"].toInt(), 6);
+    QCOMPARE(responses[5]["exitCode"].toInt(), EXIT_FAILURE);
+    QVERIFY(responses[5]["stderr"].toString().contains("Could not find entry with path /doesnotexist."));
+
+    // Only the commands meant for serving are available
+    QCOMPARE(responses[6]["exitCode"].toInt(), EXIT_FAILURE);
+    QVERIFY(responses[6]["stderr"].toString().contains("Invalid command rm."));
+
+    QVERIFY(responses[7]["id"].isNull());
+    QCOMPARE(responses[7]["exitCode"].toInt(), EXIT_FAILURE);
+
+    QCOMPARE(responses[8]["id"].toInt(), 8);
+    QCOMPARE(responses[8]["exitCode"].toInt(), EXIT_SUCCESS);
+
+    // The added entry was saved to disk
+    auto db = readDatabase();
+    QVERIFY(db);
+    auto* entry = db->rootGroup()->findEntryByPath("/newuser-entry");
+    QVERIFY(entry);
+    QCOMPARE(entry->password(), QString("newpassword"));
+
+    // An idle server locks the database on its own
+    setInput("a");
+    QCOMPARE(execCmd(serveCmd, {"serve", "--idle-timeout", "1", m_dbFile->fileName(), socketPath}), EXIT_SUCCESS);
+    QVERIFY(m_stdout->readAll().contains("Database locked."));
+
+    setInput("a");
+    QCOMPARE(execCmd(serveCmd, {"serve", "--idle-timeout", "-1", m_dbFile->fileName(), socketPath}), EXIT_FAILURE);
+    QVERIFY(m_stderr->readAll().contains("Invalid idle timeout -1."));
+}
+
+void TestCli::benchmarkServe()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    Serve serveCmd;
+    QTemporaryDir socketDir;
+    QVERIFY(socketDir.isValid());
+    const auto socketPath = socketDir.filePath("serve.socket");
+
+    const int count = 1000;
+    QList<QByteArray> requests;
+    for (int i = 0; i < count; ++i) {
+        requests << QString(R"({"id":%1,"command":"show","arguments":["-a","Password","/Sample Entry"]})")
+                        .arg(i)
+                        .toUtf8();
+    }
+    requests << R"({"command":"lock"})";
+
+    QList<QJsonObject> responses;
+    QBENCHMARK_ONCE
+    {
+        auto future = QtConcurrent::run([socketPath, requests] { return serveRequests(socketPath, requests); });
+        setInput("a");
+        QCOMPARE(execCmd(serveCmd, {"serve", "-q", m_dbFile->fileName(), socketPath}), EXIT_SUCCESS);
+        responses = future.result();
+    }
+
+    QCOMPARE(responses.size(), count + 1);
+    QCOMPARE(responses[count - 1]["stdout"].toString(), QString("Password\n"));
+}
+
 void TestCli::testShow()
 {
     Show showCmd;
@@ -2393,3 +2548,35 @@ void TestCli::testHelp()
     execCmd(helpCmd, {"help", "ls"});
     QVERIFY(m_stdout->readAll().contains(listCmd.description.toLatin1()));
 }
+
+void TestCli::testHibpIndex()
+{
+    HibpIndex hibpIndexCmd;
+    QVERIFY(!hibpIndexCmd.name.isEmpty());
+    QVERIFY(hibpIndexCmd.getDescriptionLine().contains(hibpIndexCmd.name));
+
+    const QString hibpPath = QString(KEEPASSX_TEST_DATA_DIR).append("/hibp.txt");
+
+    TemporaryFile indexFile;
+    QVERIFY(indexFile.open());
+    indexFile.close();
+
+    QCOMPARE(execCmd(hibpIndexCmd, {"hibp-index", hibpPath, indexFile.fileName()}), EXIT_SUCCESS);
+    QVERIFY(m_stdout->readAll().contains(indexFile.fileName().toUtf8()));
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    // The index can be used in place of the text file
+    Analyze analyzeCmd;
+    setInput("a");
+    execCmd(analyzeCmd, {"analyze", "--hibp", indexFile.fileName(), m_dbFile->fileName()});
+    auto output = m_stdout->readAll();
+    QVERIFY(output.contains("Sample Entry"));
+    QVERIFY(output.contains("123"));
+    m_stderr->readLine(); // Skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    // An index cannot be indexed again
+    QCOMPARE(execCmd(hibpIndexCmd, {"hibp-index", indexFile.fileName(), indexFile.fileName() + ".2"}),
+             EXIT_FAILURE);
+    QVERIFY(!m_stderr->readAll().isEmpty());
+}
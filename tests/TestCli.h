@@ -67,6 +67,7 @@ private slots:
     void testKeyFileOption();
     void testNoPasswordOption();
     void testHelp();
+    void testHibpIndex();
     void testInteractiveCommands();
     void testList();
     void testMerge();
@@ -77,6 +78,8 @@ private slots:
     void testRemoveGroup();
     void testRemoveQuiet();
     void testSearch();
+    void testServe();
+    void benchmarkServe();
     void testShow();
     void testInvalidDbFiles();
     void testYubiKeyOption();
@@ -17,6 +17,7 @@
 
 #include "TestConfig.h"
 
+#include <QSettings>
 #include <QTest>
 
 #include "config-keepassx-tests.h"
@@ -40,3 +41,63 @@ void TestConfig::testUpgrade()
 
     tempFile.remove();
 }
+
+void TestConfig::testCachedValues()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    tempFile.close();
+    Config::createConfigFromFile(tempFile.fileName());
+
+    QCOMPARE(config()->get(Config::AutoTypeEntryTitleMatch), config()->getDefault(Config::AutoTypeEntryTitleMatch));
+
+    QList<Config::ConfigKey> changedKeys;
+    connect(config(), &Config::changed, this, [&](Config::ConfigKey key) { changedKeys << key; });
+
+    config()->set(Config::AutoTypeEntryTitleMatch, false);
+    QCOMPARE(changedKeys.size(), 1);
+    QCOMPARE(config()->get(Config::AutoTypeEntryTitleMatch), QVariant(false));
+
+    // Setting the same value again does not notify
+    config()->set(Config::AutoTypeEntryTitleMatch, false);
+    QCOMPARE(changedKeys.size(), 1);
+
+    config()->remove(Config::AutoTypeEntryTitleMatch);
+    QCOMPARE(changedKeys.size(), 2);
+    QCOMPARE(config()->get(Config::AutoTypeEntryTitleMatch), config()->getDefault(Config::AutoTypeEntryTitleMatch));
+
+    // Values read back from the file keep the type of their default
+    config()->set(Config::Security_ClearClipboardTimeout, 42);
+    config()->sync();
+    Config::createConfigFromFile(tempFile.fileName());
+    QCOMPARE(config()->get(Config::Security_ClearClipboardTimeout).userType(), static_cast<int>(QMetaType::Int));
+    QCOMPARE(config()->get(Config::Security_ClearClipboardTimeout).toInt(), 42);
+
+    tempFile.remove();
+}
+
+void TestConfig::testExternalChange()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.open());
+    tempFile.close();
+    Config::createConfigFromFile(tempFile.fileName());
+
+    config()->set(Config::Security_ClearClipboardTimeout, 10);
+    config()->sync();
+
+    QList<Config::ConfigKey> changedKeys;
+    connect(config(), &Config::changed, this, [&](Config::ConfigKey key) { changedKeys << key; });
+
+    // Another instance changes the settings file
+    {
+        QSettings settings(tempFile.fileName(), QSettings::IniFormat);
+        settings.setValue("Security/ClearClipboardTimeout", 25);
+        settings.sync();
+    }
+
+    QTRY_COMPARE(config()->get(Config::Security_ClearClipboardTimeout).toInt(), 25);
+    QCOMPARE(changedKeys, QList<Config::ConfigKey>() << Config::Security_ClearClipboardTimeout);
+
+    tempFile.remove();
+}
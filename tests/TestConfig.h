@@ -25,6 +25,8 @@ class TestConfig : public QObject
     Q_OBJECT
 private slots:
     void testUpgrade();
+    void testCachedValues();
+    void testExternalChange();
 };
 
 #endif // KEEPASSX_TESTCONFIG_H
@@ -104,6 +104,48 @@ void TestDatabase::testSave()
     QVERIFY(!QFile::exists(backupFilePath));
 }
 
+void TestDatabase::testSavePrecomputedKey()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+    db->setPrecomputeNextKey(true);
+
+    auto verifySave = [&](const QSharedPointer<const CompositeKey>& expectedKey) {
+        const auto seed = db->kdf()->seed();
+        db->metadata()->setName(QUuid::createUuid().toString());
+        QVERIFY2(db->save(Database::Atomic, {}, &error), error.toLatin1());
+        QVERIFY(!db->isModified());
+        QVERIFY(db->kdf()->seed() != seed);
+
+        auto reopened = QSharedPointer<Database>::create();
+        QVERIFY2(reopened->open(tempFile.fileName(), expectedKey, &error), error.toLatin1());
+        QCOMPARE(reopened->metadata()->name(), db->metadata()->name());
+        QCOMPARE(reopened->kdf()->seed(), db->kdf()->seed());
+    };
+
+    // Consecutive saves use the key derived in the background
+    verifySave(key);
+    verifySave(key);
+
+    // Changed KDF parameters invalidate the precomputed key
+    QVERIFY(db->kdf()->setRounds(db->kdf()->rounds() + 1));
+    verifySave(key);
+
+    // So does a new database key
+    auto newKey = QSharedPointer<CompositeKey>::create();
+    newKey->addKey(QSharedPointer<PasswordKey>::create("b"));
+    QVERIFY(db->setKey(newKey, true, false, false));
+    verifySave(newKey);
+    verifySave(newKey);
+}
+
 void TestDatabase::testSaveAs()
 {
     TemporaryFile tempFile;
@@ -268,3 +310,137 @@ void TestDatabase::testCustomIcons()
     QCOMPARE(iconData.name, QString("Test"));
     QCOMPARE(iconData.lastModified, date);
 }
+
+void TestDatabase::testUuidIndex()
+{
+    Database db;
+    auto root = db.rootGroup();
+
+    auto group1 = new Group();
+    group1->setUuid(QUuid::createUuid());
+    group1->setParent(root);
+    auto group2 = new Group();
+    group2->setUuid(QUuid::createUuid());
+    group2->setParent(group1);
+
+    auto entry1 = new Entry();
+    entry1->setGroup(group1);
+    entry1->setUuid(QUuid::createUuid());
+    auto entry2 = new Entry();
+    entry2->setUuid(QUuid::createUuid());
+    entry2->setGroup(group2);
+    QVERIFY(db.verifyUuidIndex());
+
+    QCOMPARE(root->findEntryByUuid(entry1->uuid()), entry1);
+    QCOMPARE(root->findEntryByUuid(entry2->uuid()), entry2);
+    QCOMPARE(group1->findEntryByUuid(entry2->uuid()), entry2);
+    QVERIFY(!group1->findEntryByUuid(entry2->uuid(), false));
+    QVERIFY(!group2->findEntryByUuid(entry1->uuid()));
+    QCOMPARE(root->findGroupByUuid(group2->uuid()), group2);
+    QCOMPARE(group2->findGroupByUuid(group2->uuid()), group2);
+    QVERIFY(!group2->findGroupByUuid(group1->uuid()));
+
+    // Changing the uuid updates the index
+    const auto oldUuid = entry1->uuid();
+    entry1->setUuid(QUuid::createUuid());
+    QVERIFY(!root->findEntryByUuid(oldUuid));
+    QCOMPARE(root->findEntryByUuid(entry1->uuid()), entry1);
+
+    // Moving a subtree to another database moves its index entries
+    Database db2;
+    group1->setParent(db2.rootGroup());
+    QVERIFY(db.verifyUuidIndex());
+    QVERIFY(db2.verifyUuidIndex());
+    QVERIFY(!root->findEntryByUuid(entry2->uuid()));
+    QVERIFY(!root->findGroupByUuid(group2->uuid()));
+    QCOMPARE(db2.rootGroup()->findEntryByUuid(entry2->uuid()), entry2);
+    QCOMPARE(db2.rootGroup()->findGroupByUuid(group2->uuid()), group2);
+
+    // Removed and deleted objects are dropped from the index
+    const auto entry2Uuid = entry2->uuid();
+    delete entry2;
+    QVERIFY(!db2.rootGroup()->findEntryByUuid(entry2Uuid));
+    const auto group2Uuid = group2->uuid();
+    delete group2;
+    QVERIFY(!db2.rootGroup()->findGroupByUuid(group2Uuid));
+    QVERIFY(db2.verifyUuidIndex());
+
+    // Groups without a database fall back to walking the tree
+    Group detached;
+    auto entry3 = new Entry();
+    entry3->setUuid(QUuid::createUuid());
+    entry3->setGroup(&detached);
+    QCOMPARE(detached.findEntryByUuid(entry3->uuid()), entry3);
+}
+
+void TestDatabase::testTagAndUsernameIndexes()
+{
+    Database db;
+    auto root = db.rootGroup();
+    QSignalSpy spyTagList(&db, SIGNAL(tagListUpdated()));
+
+    auto group1 = new Group();
+    group1->setParent(root);
+    auto entry1 = new Entry();
+    entry1->setTags("b;a");
+    entry1->setUsername("alice");
+    entry1->setGroup(group1);
+    auto entry2 = new Entry();
+    entry2->setTags("b");
+    entry2->setUsername("bob");
+    entry2->setGroup(root);
+    auto entry3 = new Entry();
+    entry3->setUsername("alice");
+    entry3->setGroup(root);
+
+    QCOMPARE(db.tagList(), QStringList({"a", "b"}));
+    QCOMPARE(spyTagList.count(), 1);
+
+    // Edits that keep the set of tags unchanged do not publish a new list
+    entry1->setTitle("title");
+    entry2->addTag("a");
+    entry2->setGroup(group1);
+    QCOMPARE(spyTagList.count(), 1);
+
+    entry3->addTag("c");
+    QCOMPARE(db.tagList(), QStringList({"a", "b", "c"}));
+    QCOMPARE(spyTagList.count(), 2);
+
+    // Usernames are counted incrementally
+    db.updateCommonUsernames();
+    QCOMPARE(db.commonUsernames(), QStringList({"alice", "bob"}));
+    entry2->setUsername("alice");
+    entry3->setUsername("{REF:U@I:00000000000000000000000000000000}");
+    db.updateCommonUsernames();
+    QCOMPARE(db.commonUsernames(), QStringList({"alice"}));
+
+    // Tags of recycled entries are dropped
+    db.recycleEntry(entry3);
+    QCOMPARE(db.tagList(), QStringList({"a", "b"}));
+    db.recycleGroup(group1);
+    QVERIFY(db.tagList().isEmpty());
+    QCOMPARE(spyTagList.count(), 4);
+
+    // Restoring a group indexes its entries again
+    group1->setParent(root);
+    QCOMPARE(db.tagList(), QStringList({"a", "b"}));
+
+    // Removing a tag only touches tagged entries, including recycled ones
+    entry3->addTag("a");
+    db.removeTag("a");
+    QCOMPARE(db.tagList(), QStringList({"b"}));
+    QCOMPARE(entry1->tagList(), QStringList({"b"}));
+    QCOMPARE(entry3->tagList(), QStringList({"c"}));
+
+    // Moving entries to another database updates both indexes
+    Database db2;
+    group1->setParent(db2.rootGroup());
+    QVERIFY(db.tagList().isEmpty());
+    QCOMPARE(db2.tagList(), QStringList({"b"}));
+
+    delete entry1;
+    delete entry2;
+    QVERIFY(db2.tagList().isEmpty());
+    db2.updateCommonUsernames();
+    QVERIFY(db2.commonUsernames().isEmpty());
+}
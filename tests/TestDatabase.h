@@ -29,6 +29,7 @@ private slots:
     void initTestCase();
     void testOpen();
     void testSave();
+    void testSavePrecomputedKey();
     void testSaveAs();
     void testSignals();
     void testEmptyRecycleBinOnDisabled();
@@ -36,6 +37,8 @@ private slots:
     void testEmptyRecycleBinOnEmpty();
     void testEmptyRecycleBinWithHierarchicalData();
     void testCustomIcons();
+    void testUuidIndex();
+    void testTagAndUsernameIndexes();
 };
 
 #endif // KEEPASSX_TESTDATABASE_H
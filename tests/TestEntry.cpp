@@ -24,6 +24,7 @@
 #include "core/Metadata.h"
 #include "core/TimeInfo.h"
 #include "crypto/Crypto.h"
+#include "crypto/CryptoHash.h"
 
 QTEST_GUILESS_MAIN(TestEntry)
 
@@ -82,6 +83,50 @@ void TestEntry::testCopyDataFrom()
     QCOMPARE(entry2->autoTypeAssociations()->get(1).window, QString("3"));
 }
 
+void TestEntry::testAttachmentHash()
+{
+    QScopedPointer<Entry> entry(new Entry());
+    QCOMPARE(entry->attachments()->hash("missing"), QByteArray());
+
+    entry->attachments()->set("test", "123");
+    QCOMPARE(entry->attachments()->hash("test"), CryptoHash::hash("123", CryptoHash::Sha256));
+
+    // Copies (e.g. history items) share the digest
+    QScopedPointer<Entry> entry2(new Entry());
+    entry2->copyDataFrom(entry.data());
+    QCOMPARE(entry2->attachments()->hash("test"), entry->attachments()->hash("test"));
+
+    // Changing the data changes the digest of that copy only
+    entry2->attachments()->set("test", "456");
+    QCOMPARE(entry2->attachments()->hash("test"), CryptoHash::hash("456", CryptoHash::Sha256));
+    QCOMPARE(entry->attachments()->hash("test"), CryptoHash::hash("123", CryptoHash::Sha256));
+    QVERIFY(*entry->attachments() != *entry2->attachments());
+
+    entry2->attachments()->set("test", "123");
+    QVERIFY(*entry->attachments() == *entry2->attachments());
+
+    entry2->attachments()->rename("test", "renamed");
+    QCOMPARE(entry2->attachments()->hash("renamed"), CryptoHash::hash("123", CryptoHash::Sha256));
+    QCOMPARE(entry2->attachments()->hash("test"), QByteArray());
+
+    // Data is never shared by address, a raw buffer may be reused for other contents
+    char buffer[] = "abc";
+    entry->attachments()->set("raw", QByteArray::fromRawData(buffer, 3));
+    QCOMPARE(entry->attachments()->hash("raw"), CryptoHash::hash("abc", CryptoHash::Sha256));
+    buffer[0] = 'x';
+    entry2->attachments()->set("raw", QByteArray::fromRawData(buffer, 3));
+    QCOMPARE(entry2->attachments()->hash("raw"), CryptoHash::hash("xbc", CryptoHash::Sha256));
+    entry->attachments()->remove("raw");
+    entry2->attachments()->remove("raw");
+
+    // Attachments set from the same blob share it
+    auto blob = QSharedPointer<const EntryAttachments::Blob>::create(QByteArray("shared"));
+    entry->attachments()->setBlob("shared", blob);
+    entry2->attachments()->setBlob("shared", blob);
+    QCOMPARE(entry->attachments()->hash("shared"), CryptoHash::hash("shared", CryptoHash::Sha256));
+    QCOMPARE(entry2->attachments()->value("shared"), QByteArray("shared"));
+}
+
 void TestEntry::testClone()
 {
     QScopedPointer<Entry> entryOrg(new Entry());
@@ -22,6 +22,7 @@
 
 #include "core/Entry.h"
 #include "core/Group.h"
+#include "core/Merger.h"
 #include "crypto/Crypto.h"
 #include "gui/DatabaseIcons.h"
 #include "gui/IconModels.h"
@@ -346,6 +347,59 @@ void TestEntryModel::testProxyModel()
     delete db;
 }
 
+void TestEntryModel::testProxyModelSortCollationKeys()
+{
+    auto modelSource = new EntryModel(this);
+    auto modelProxy = new SortFilterHideProxyModel(this);
+    modelProxy->setSourceModel(modelSource);
+    modelProxy->setSortRole(Qt::UserRole);
+
+    auto modelTest = new ModelTest(modelProxy, this);
+
+    auto db = new Database();
+    QStringList titles = {"Entry 10", "entry 1", "Entry 2", "{USERNAME}"};
+    QList<Entry*> entries;
+    for (const auto& title : titles) {
+        auto entry = new Entry();
+        entry->setTitle(title);
+        entry->setUsername("Entry 3");
+        entry->setGroup(db->rootGroup());
+        entries << entry;
+    }
+
+    modelSource->setGroup(db->rootGroup());
+    modelProxy->sort(EntryModel::Title, Qt::AscendingOrder);
+
+    auto sortedTitles = [&]() {
+        QStringList result;
+        for (int row = 0; row < modelProxy->rowCount(); ++row) {
+            result << modelProxy->index(row, EntryModel::Title).data(Qt::UserRole).toString();
+        }
+        return result;
+    };
+
+    // Titles with placeholders are not cached but sort together with cached ones
+    QVERIFY(modelSource->index(0, EntryModel::Title).data(SortFilterHideProxyModel::CollationKeyRole).isValid());
+    QVERIFY(!modelSource->index(3, EntryModel::Title).data(SortFilterHideProxyModel::CollationKeyRole).isValid());
+    QCOMPARE(sortedTitles(), QStringList({"entry 1", "Entry 2", "Entry 3", "Entry 10"}));
+
+    // Changed entries are sorted by their new value
+    entries[0]->setTitle("Entry 0");
+    QCOMPARE(sortedTitles(), QStringList({"Entry 0", "entry 1", "Entry 2", "Entry 3"}));
+
+    entries[3]->setUsername("Entry 20");
+    QCOMPARE(sortedTitles(), QStringList({"Entry 0", "entry 1", "Entry 2", "Entry 20"}));
+
+    // Keys are cached per column
+    modelProxy->sort(EntryModel::Username, Qt::DescendingOrder);
+    QCOMPARE(modelProxy->index(0, EntryModel::Username).data(Qt::UserRole).toString(), QString("Entry 20"));
+
+    delete modelTest;
+    delete modelProxy;
+    delete modelSource;
+    delete db;
+}
+
 void TestEntryModel::testDatabaseDelete()
 {
     auto model = new EntryModel(this);
@@ -376,3 +430,45 @@ void TestEntryModel::testDatabaseDelete()
     delete modelTest;
     delete model;
 }
+
+void TestEntryModel::testMerge()
+{
+    Database db;
+    auto entry1 = new Entry();
+    entry1->setUuid(QUuid::createUuid());
+    entry1->setGroup(db.rootGroup());
+
+    Database sourceDb;
+    for (int i = 0; i < 3; ++i) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setGroup(sourceDb.rootGroup());
+    }
+
+    auto model = new EntryModel(this);
+    auto modelTest = new ModelTest(model, this);
+    model->setGroup(db.rootGroup());
+    QCOMPARE(model->rowCount(), 1);
+
+    QSignalSpy spyReset(model, SIGNAL(modelReset()));
+    QSignalSpy spyInserted(model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+
+    Merger merger(&sourceDb, &db);
+    merger.merge();
+
+    // The whole merge is a single reset instead of one insertion per entry
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyInserted.count(), 0);
+    QCOMPARE(model->rowCount(), 4);
+    QCOMPARE(model->entryFromIndex(model->index(0, 0)), entry1);
+
+    // Changes after the merge are handled individually again
+    auto entry2 = new Entry();
+    entry2->setGroup(db.rootGroup());
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyInserted.count(), 1);
+    QCOMPARE(model->rowCount(), 5);
+
+    delete modelTest;
+    delete model;
+}
@@ -33,7 +33,9 @@ private slots:
     void testCustomIconModel();
     void testAutoTypeAssociationsModel();
     void testProxyModel();
+    void testProxyModelSortCollationKeys();
     void testDatabaseDelete();
+    void testMerge();
 };
 
 #endif // KEEPASSX_TESTENTRYMODEL_H
@@ -17,9 +17,11 @@
 
 #include "TestFdoSecrets.h"
 
+#include "core/Database.h"
 #include "core/EntrySearcher.h"
 #include "core/Group.h"
 #include "crypto/Random.h"
+#include "fdosecrets/objects/AttributeIndex.h"
 #include "fdosecrets/objects/Collection.h"
 #include "fdosecrets/objects/SessionCipher.h"
 
@@ -124,3 +126,71 @@ void TestFdoSecrets::testDBusPathParse()
     parsed = DBusMgr::parsePath(QStringLiteral("/org"));
     QCOMPARE(parsed.type, PathType::Unknown);
 }
+
+void TestFdoSecrets::testAttributeIndex()
+{
+    using FdoSecrets::AttributeIndex;
+    using FdoSecrets::Collection;
+
+    Database db;
+    auto root = db.rootGroup();
+    auto sub = new Group();
+    sub->setUuid(QUuid::createUuid());
+    sub->setParent(root);
+
+    auto e1 = new Entry();
+    e1->setUuid(QUuid::createUuid());
+    e1->setTitle("title");
+    e1->setUsername("user");
+    e1->attributes()->set("service", "mail");
+    e1->setGroup(sub);
+
+    auto e2 = new Entry();
+    e2->setUuid(QUuid::createUuid());
+    e2->setTitle("title\n");
+    e2->setUsername("{REF:U@I:" + e1->uuidToHex() + "}");
+    e2->attributes()->set("service", "mail");
+    e2->attributes()->set("secret", "mail", true);
+    e2->setGroup(root);
+
+    auto e3 = new Entry();
+    e3->setUuid(QUuid::createUuid());
+    e3->setTitle("Title");
+    e3->attributes()->set("service", "calendar");
+    e3->setGroup(root);
+
+    // the index only preselects entries, the results must be the same as a full search
+    AttributeIndex index(&db, root);
+    auto check = [&](const FdoSecrets::StringStringMap& attributes, const QList<Entry*>& expected) {
+        QList<EntrySearcher::SearchTerm> terms;
+        for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+            terms << Collection::attributeToTerm(it.key(), it.value());
+        }
+        EntrySearcher searcher(false, true);
+        QCOMPARE(searcher.search(terms, root, true), expected);
+        QCOMPARE(searcher.searchEntries(terms, index.candidates(attributes)), expected);
+    };
+
+    check({{"Title", "title"}}, {e2, e1});
+    check({{"Title", "title\n"}}, {e2});
+    check({{"UserName", "user"}}, {e2, e1});
+    check({{"service", "mail"}}, {e2, e1});
+    check({{"service", "mail"}, {"Title", "Title"}}, {});
+    check({{"service", "calendar"}, {"Title", "Title"}}, {e3});
+    // terms for protected attributes are ignored
+    check({{"secret", "other"}, {"service", "mail"}}, {e2});
+    check({{"secret", "mail"}}, {});
+    check({}, {});
+
+    // changes are tracked
+    e3->attributes()->set("service", "mail");
+    check({{"service", "mail"}}, {e2, e3, e1});
+    e1->setUsername("other");
+    check({{"UserName", "other"}}, {e2, e1});
+    e3->setGroup(sub);
+    check({{"service", "mail"}}, {e2, e1, e3});
+    delete e1;
+    check({{"service", "mail"}}, {e2, e3});
+    delete sub;
+    check({{"service", "mail"}}, {e2});
+}
@@ -1319,3 +1319,164 @@ void TestGroup::testAutoTypeState()
     QVERIFY(!entry1->groupAutoTypeEnabled());
     QVERIFY(entry2->groupAutoTypeEnabled());
 }
+
+void TestGroup::testResolvedPropertiesInvalidation()
+{
+    Database db;
+    auto* root = db.rootGroup();
+
+    auto group1 = new Group();
+    group1->setParent(root);
+    auto group2 = new Group();
+    group2->setParent(group1);
+    auto group3 = new Group();
+    group3->setParent(root);
+
+    // Resolve once to populate the cached values
+    QVERIFY(group2->resolveSearchingEnabled());
+    QVERIFY(group2->resolveAutoTypeEnabled());
+    QVERIFY(!group2->isRecycled());
+    QCOMPARE(group2->resolveCustomDataTriState("key"), Group::Inherit);
+    QVERIFY(group2->resolveCustomDataString("key").isEmpty());
+
+    // Changing an ancestor updates its descendants
+    group1->setSearchingEnabled(Group::Disable);
+    root->setAutoTypeEnabled(Group::Disable);
+    QVERIFY(!group2->resolveSearchingEnabled());
+    QVERIFY(!group2->resolveAutoTypeEnabled());
+
+    root->setCustomDataTriState("key", Group::Enable);
+    QCOMPARE(group2->resolveCustomDataTriState("key"), Group::Enable);
+    QCOMPARE(group2->resolveCustomDataTriState("key", false), Group::Inherit);
+    group1->customData()->set("key", "value");
+    QCOMPARE(group2->resolveCustomDataString("key"), QString("value"));
+    QCOMPARE(group2->resolveCustomDataTriState("key"), Group::Disable);
+
+    // Changing an inherited value in place is picked up without invalidation
+    group1->customData()->set("key", "other");
+    QCOMPARE(group2->resolveCustomDataString("key"), QString("other"));
+    group1->customData()->remove("key");
+    QCOMPARE(group2->resolveCustomDataTriState("key"), Group::Enable);
+
+    // Moving a group resolves against its new parents
+    group2->setParent(group3);
+    QVERIFY(group2->resolveSearchingEnabled());
+    QVERIFY(!group2->resolveAutoTypeEnabled());
+    group3->setAutoTypeEnabled(Group::Enable);
+    QVERIFY(group2->resolveAutoTypeEnabled());
+
+    // Recycling and replacing the recycle bin
+    db.recycleGroup(group3);
+    QVERIFY(group3->isRecycled());
+    QVERIFY(group2->isRecycled());
+    db.metadata()->setRecycleBin(group1);
+    QVERIFY(!group2->isRecycled());
+    QVERIFY(group1->isRecycled());
+
+    // Groups without a database are never recycled
+    group2->setParent(group1);
+    QVERIFY(group2->isRecycled());
+    Group detached;
+    group2->setParent(&detached);
+    QVERIFY(!group2->isRecycled());
+    QVERIFY(group2->resolveSearchingEnabled());
+}
+
+void TestGroup::testForEachRecursive()
+{
+    Database db;
+    auto* root = db.rootGroup();
+
+    auto group1 = new Group();
+    group1->setParent(root);
+    auto group2 = new Group();
+    group2->setParent(group1);
+    auto group3 = new Group();
+    group3->setParent(root);
+
+    for (auto* group : {root, group1, group2, group3, group2}) {
+        auto entry = new Entry();
+        entry->setGroup(group);
+        entry->beginUpdate();
+        entry->setTitle("title");
+        entry->endUpdate();
+    }
+
+    // Traversal order matches the list based accessors
+    QList<const Group*> groups;
+    root->forEachGroupRecursive([&groups](const Group* group) { groups.append(group); });
+    QCOMPARE(groups, root->groupsRecursive(true));
+    groups.clear();
+    root->forEachGroupRecursive([&groups](const Group* group) { groups.append(group); }, false);
+    QCOMPARE(groups, root->groupsRecursive(false));
+
+    for (bool includeHistoryItems : {false, true}) {
+        QList<Entry*> entries;
+        root->forEachEntryRecursive([&entries](Entry* entry) { entries.append(entry); }, includeHistoryItems);
+        QCOMPARE(entries, root->entriesRecursive(includeHistoryItems));
+    }
+
+    // Returning false stops the traversal
+    int visited = 0;
+    QVERIFY(!root->forEachEntryRecursive([&visited](Entry*) { return ++visited < 2; }));
+    QCOMPARE(visited, 2);
+    visited = 0;
+    QVERIFY(!root->forEachGroupRecursive([&visited, group2](Group* group) {
+        ++visited;
+        return group != group2;
+    }));
+    QCOMPARE(visited, 3);
+    QVERIFY(root->forEachGroupRecursive([](Group*) { return true; }));
+}
+
+void TestGroup::benchmarkTreeTraversal_data()
+{
+    QTest::addColumn<bool>("visitor");
+    QTest::newRow("entriesRecursive") << false;
+    QTest::newRow("forEachEntryRecursive") << true;
+}
+
+void TestGroup::benchmarkTreeTraversal()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(bool, visitor);
+
+    // 100k entries spread over three levels of 10 groups each
+    Group root;
+    QList<Group*> parents = {&root};
+    for (int level = 0; level < 3; ++level) {
+        QList<Group*> children;
+        for (auto* parent : asConst(parents)) {
+            for (int i = 0; i < 10; ++i) {
+                auto group = new Group();
+                group->setParent(parent);
+                children.append(group);
+            }
+        }
+        parents = children;
+    }
+    for (auto* group : asConst(parents)) {
+        for (int i = 0; i < 100; ++i) {
+            auto entry = new Entry();
+            entry->setGroup(group);
+        }
+    }
+
+    int count = 0;
+    QBENCHMARK
+    {
+        count = 0;
+        if (visitor) {
+            root.forEachEntryRecursive([&count](const Entry* entry) { count += entry->isExpired() ? 0 : 1; });
+        } else {
+            for (const auto* entry : root.entriesRecursive()) {
+                count += entry->isExpired() ? 0 : 1;
+            }
+        }
+    }
+    QCOMPARE(count, 100000);
+}
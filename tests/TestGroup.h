@@ -50,6 +50,10 @@ private slots:
     void testMoveUpDown();
     void testPreviousParentGroup();
     void testAutoTypeState();
+    void testResolvedPropertiesInvalidation();
+    void testForEachRecursive();
+    void benchmarkTreeTraversal_data();
+    void benchmarkTreeTraversal();
 };
 
 #endif // KEEPASSX_TESTGROUP_H
@@ -21,6 +21,7 @@
 #include <QTest>
 
 #include "core/Group.h"
+#include "core/Merger.h"
 #include "crypto/Crypto.h"
 #include "gui/group/GroupModel.h"
 #include "modeltest.h"
@@ -149,3 +150,45 @@ void TestGroupModel::test()
     delete modelTest;
     delete model;
 }
+
+void TestGroupModel::testMerge()
+{
+    Database db;
+    auto group1 = new Group();
+    group1->setUuid(QUuid::createUuid());
+    group1->setName("group1");
+    group1->setParent(db.rootGroup());
+
+    Database sourceDb;
+    for (int i = 0; i < 3; ++i) {
+        auto group = new Group();
+        group->setUuid(QUuid::createUuid());
+        group->setName(QString("merged%1").arg(i));
+        group->setParent(sourceDb.rootGroup());
+    }
+
+    auto model = new GroupModel(&db, this);
+    auto modelTest = new ModelTest(model, this);
+
+    QSignalSpy spyReset(model, SIGNAL(modelReset()));
+    QSignalSpy spyInserted(model, SIGNAL(rowsInserted(QModelIndex, int, int)));
+
+    Merger merger(&sourceDb, &db);
+    merger.merge();
+
+    // The whole merge is a single reset instead of one insertion per group
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyInserted.count(), 0);
+    QModelIndex indexRoot = model->index(0, 0);
+    QCOMPARE(model->rowCount(indexRoot), 4);
+    QCOMPARE(model->data(model->index(0, 0, indexRoot)).toString(), QString("group1"));
+
+    // Changes after the merge are handled individually again
+    auto group2 = new Group();
+    group2->setParent(db.rootGroup());
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyInserted.count(), 1);
+
+    delete modelTest;
+    delete model;
+}
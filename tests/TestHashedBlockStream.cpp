@@ -22,6 +22,7 @@
 #include "FailDevice.h"
 #include "crypto/Crypto.h"
 #include "streams/HashedBlockStream.h"
+#include "streams/ReadAheadStream.h"
 
 QTEST_GUILESS_MAIN(TestHashedBlockStream)
 
@@ -101,3 +102,66 @@ void TestHashedBlockStream::testWriteFailure()
     QVERIFY(!writer.reset());
     QCOMPARE(writer.errorString(), QString("FAILDEVICE"));
 }
+
+void TestHashedBlockStream::testReadAhead()
+{
+    QByteArray data;
+    for (int i = 0; i < 1000; ++i) {
+        data.append(QByteArray::number(i));
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+
+    HashedBlockStream writer(&buffer, 16);
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+    QCOMPARE(writer.write(data), qint64(data.size()));
+    QVERIFY(writer.reset());
+    buffer.reset();
+
+    HashedBlockStream reader(&buffer);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+
+    // Small chunks and a short queue, so the worker has to wait for the reader
+    ReadAheadStream readAhead(&reader, 7, 2);
+    QVERIFY(readAhead.open(QIODevice::ReadOnly));
+
+    QByteArray result;
+    QByteArray chunk;
+    while (!(chunk = readAhead.read(13)).isEmpty()) {
+        result.append(chunk);
+    }
+    QCOMPARE(result, data);
+    QCOMPARE(readAhead.read(1).size(), 0);
+    QVERIFY(readAhead.atEnd());
+}
+
+void TestHashedBlockStream::testReadAheadFailure()
+{
+    QByteArray data(100, 'x');
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+
+    HashedBlockStream writer(&buffer, 16);
+    QVERIFY(writer.open(QIODevice::WriteOnly));
+    QCOMPARE(writer.write(data), qint64(data.size()));
+    QVERIFY(writer.reset());
+
+    // Corrupt the data of the third block
+    buffer.buffer()[2 * (4 + 32 + 4 + 16) + 4 + 32 + 4] = 'y';
+    buffer.reset();
+
+    HashedBlockStream reader(&buffer);
+    QVERIFY(reader.open(QIODevice::ReadOnly));
+
+    ReadAheadStream readAhead(&reader, 8, 2);
+    QVERIFY(readAhead.open(QIODevice::ReadOnly));
+
+    // Data before the corrupt block is still delivered, then the error of the base device
+    QCOMPARE(readAhead.read(32), data.left(32));
+    char c;
+    QCOMPARE(readAhead.read(&c, 1), qint64(-1));
+    QCOMPARE(readAhead.errorString(), reader.errorString());
+    QVERIFY(!readAhead.errorString().isEmpty());
+}
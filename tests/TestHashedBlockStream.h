@@ -29,6 +29,8 @@ private slots:
     void testWriteRead();
     void testReset();
     void testWriteFailure();
+    void testReadAhead();
+    void testReadAheadFailure();
 };
 
 #endif // KEEPASSX_TESTHASHEDBLOCKSTREAM_H
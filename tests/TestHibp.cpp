@@ -23,9 +23,13 @@
 
 #include <QBuffer>
 #include <QByteArray>
+#include <QCryptographicHash>
 #include <QList>
+#include <QTemporaryFile>
 #include <QTest>
 
+#include <climits>
+
 QTEST_GUILESS_MAIN(TestHibp)
 
 const char* TEST_HIBP_CONTENTS = "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\n" // SHA-1 of "foo"
@@ -118,3 +122,298 @@ void TestHibp::testPwned()
     QCOMPARE(findings[1].first, entry4);
     QCOMPARE(findings[1].second, 456);
 }
+
+void TestHibp::testPwnedSorted()
+{
+    QStringList passwords;
+    for (int i = 0; i < 100; ++i) {
+        passwords << QString("password%1").arg(i);
+    }
+
+    QStringList lines;
+    for (int i = 0; i < passwords.size(); ++i) {
+        const auto sha1 = QCryptographicHash::hash(passwords[i].toUtf8(), QCryptographicHash::Sha1);
+        lines << QString("%1:%2\r\n").arg(QString::fromLatin1(sha1.toHex().toUpper())).arg(i + 1);
+    }
+    lines.sort();
+
+    // Every password, plus ones that sort before and after all lines in the file
+    Group* root = m_db->rootGroup();
+    passwords << "not pwned" << "also not pwned";
+    for (const auto& password : passwords) {
+        auto entry = new Entry();
+        entry->setPassword(password);
+        entry->setGroup(root);
+    }
+
+    QByteArray hibpContents = lines.join("").toLatin1();
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QVERIFY(HibpOffline::report(m_db, hibpBuffer, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 100);
+    for (int i = 0; i < findings.size(); ++i) {
+        QCOMPARE(findings[i].first->password(), passwords[i]);
+        QCOMPARE(findings[i].second, i + 1);
+    }
+}
+
+void TestHibp::testPwnedLineTerminators_data()
+{
+    QTest::addColumn<QString>("terminator");
+    QTest::newRow("CRLF") << QString("\r\n");
+    QTest::newRow("LF") << QString("\n");
+    QTest::newRow("blank lines") << QString("\n\n");
+}
+
+void TestHibp::testPwnedLineTerminators()
+{
+    QFETCH(QString, terminator);
+
+    // Every file size up to 40 lines, so the binary search probes land on
+    // every position of a line, including its terminators
+    for (int lineCount = 1; lineCount <= 40; ++lineCount) {
+        m_db.reset(new Database());
+        Group* root = m_db->rootGroup();
+
+        QStringList lines;
+        for (int i = 0; i < lineCount; ++i) {
+            const auto password = QString("password%1").arg(i);
+            const auto sha1 = QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha1);
+            lines << QString("%1:%2%3")
+                         .arg(QString::fromLatin1(sha1.toHex().toUpper()))
+                         .arg(i * 37 + 1)
+                         .arg(terminator);
+
+            auto entry = new Entry();
+            entry->setPassword(password);
+            entry->setGroup(root);
+        }
+        lines.sort();
+
+        auto entry = new Entry();
+        entry->setPassword("not pwned");
+        entry->setGroup(root);
+
+        QByteArray hibpContents = lines.join("").toLatin1();
+        QBuffer hibpBuffer(&hibpContents);
+        QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+        QList<QPair<const Entry*, int>> findings;
+        QString error;
+        QVERIFY2(HibpOffline::report(m_db, hibpBuffer, findings, &error), qPrintable(error));
+        QCOMPARE(findings.size(), lineCount);
+        for (int i = 0; i < findings.size(); ++i) {
+            QCOMPARE(findings[i].second, i * 37 + 1);
+        }
+    }
+}
+
+void TestHibp::testPwnedUnsorted()
+{
+    QStringList lines;
+    Group* root = m_db->rootGroup();
+    for (int i = 0; i < 100; ++i) {
+        const auto password = QString("password%1").arg(i);
+        const auto sha1 = QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha1);
+        lines << QString("%1:%2\n").arg(QString::fromLatin1(sha1.toHex().toUpper())).arg(i + 1);
+
+        auto entry = new Entry();
+        entry->setPassword(password);
+        entry->setGroup(root);
+    }
+    lines.sort();
+
+    // Ordered by something else than the hash, e.g. by prevalence
+    QStringList reversed;
+    for (auto it = lines.crbegin(); it != lines.crend(); ++it) {
+        reversed << *it;
+    }
+    // Only the lines between the first and the last one are out of order
+    QStringList shuffled = reversed;
+    shuffled.first() = lines.first();
+    shuffled.last() = lines.last();
+
+    for (const auto& contents : {reversed, shuffled}) {
+        QByteArray hibpContents = contents.join("").toLatin1();
+        QBuffer hibpBuffer(&hibpContents);
+        QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+        QList<QPair<const Entry*, int>> findings;
+        QString error;
+        QVERIFY(!HibpOffline::report(m_db, hibpBuffer, findings, &error));
+        QVERIFY(error.contains("not ordered"));
+    }
+}
+
+void TestHibp::testPwnedLargeCount()
+{
+    QByteArray hibpContents("0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:99999999999999999999\n");
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    auto entry = new Entry();
+    entry->setPassword("foo");
+    entry->setGroup(m_db->rootGroup());
+
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QVERIFY(HibpOffline::report(m_db, hibpBuffer, findings, &error));
+    QCOMPARE(findings.size(), 1);
+    QCOMPARE(findings[0].second, INT_MAX);
+}
+
+void TestHibp::testIndex()
+{
+    QByteArray hibpContents(TEST_HIBP_CONTENTS);
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    QByteArray indexContents;
+    QBuffer indexBuffer(&indexContents);
+    QVERIFY(indexBuffer.open(QIODevice::WriteOnly));
+
+    QString error;
+    QVERIFY(HibpOffline::buildIndex(hibpBuffer, indexBuffer, &error));
+    QCOMPARE(error, QString());
+    indexBuffer.close();
+
+    // Header, fan-out table and 12 bytes per record
+    QCOMPARE(indexContents.size(), 24 + 65536 * 8 + 2 * 12);
+
+    Group* root = m_db->rootGroup();
+
+    auto entry1 = new Entry();
+    entry1->setPassword("bar");
+    entry1->setGroup(root);
+
+    auto entry2 = new Entry();
+    entry2->setPassword("xyz");
+    entry2->setGroup(root);
+
+    auto entry3 = new Entry();
+    entry3->setPassword("foo");
+    entry3->setGroup(root);
+
+    QVERIFY(indexBuffer.open(QIODevice::ReadOnly));
+    QList<QPair<const Entry*, int>> findings;
+    QVERIFY(HibpOffline::report(m_db, indexBuffer, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 2);
+    QCOMPARE(findings[0].first, entry1);
+    QCOMPARE(findings[0].second, 456);
+    QCOMPARE(findings[1].first, entry3);
+    QCOMPARE(findings[1].second, 123);
+
+    // A truncated index is rejected
+    indexBuffer.close();
+    indexContents.chop(1);
+    QVERIFY(indexBuffer.open(QIODevice::ReadOnly));
+    findings.clear();
+    QVERIFY(!HibpOffline::report(m_db, indexBuffer, findings, &error));
+    QVERIFY(!error.isEmpty());
+    QCOMPARE(findings.size(), 0);
+}
+
+void TestHibp::testIndexUnsorted()
+{
+    QByteArray hibpContents("62CDB7020FF920E5AA642C3D4066950DD1F01F4D:456\n"
+                            "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\n");
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    QByteArray indexContents;
+    QBuffer indexBuffer(&indexContents);
+    QVERIFY(indexBuffer.open(QIODevice::WriteOnly));
+
+    QString error;
+    QVERIFY(!HibpOffline::buildIndex(hibpBuffer, indexBuffer, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+namespace
+{
+    // Fixed-width synthetic HIBP lines: "XXXXXXXX" + 32 zeros + ":" + 3 digit count + "\n"
+    const qint64 SPARSE_LINE_WIDTH = 45;
+
+    QByteArray sparseLine(qint64 index)
+    {
+        return QString("%1%2:%3\n")
+            .arg(static_cast<quint32>(index << 5), 8, 16, QChar('0'))
+            .arg(QString(32, '0'))
+            .arg(index % 1000, 3, 10, QChar('0'))
+            .toUpper()
+            .toLatin1();
+    }
+
+    // The file is sparse, so only the lines a binary search for upperHex
+    // would probe are actually written; everything else is a hole.
+    bool materializeSearchPath(QFile& file, qint64 numLines, const QByteArray& upperHex)
+    {
+        qint64 lo = 0;
+        qint64 hi = numLines * SPARSE_LINE_WIDTH;
+        while (lo < hi) {
+            const qint64 index = (lo + (hi - lo) / 2) / SPARSE_LINE_WIDTH;
+            const QByteArray line = sparseLine(index);
+            if (!file.seek(index * SPARSE_LINE_WIDTH) || file.write(line) != line.size()) {
+                return false;
+            }
+
+            const int cmp = qstrcmp(line.left(40), upperHex);
+            if (cmp == 0) {
+                break;
+            } else if (cmp < 0) {
+                lo = (index + 1) * SPARSE_LINE_WIDTH;
+            } else {
+                hi = index * SPARSE_LINE_WIDTH;
+            }
+        }
+        return true;
+    }
+} // namespace
+
+void TestHibp::benchmarkSparseFile()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    // 2^27 lines of 45 bytes, about 6 GB, the order of magnitude of the real HIBP file
+    const qint64 numLines = Q_INT64_C(1) << 27;
+
+    QTemporaryFile hibpFile;
+    QVERIFY(hibpFile.open());
+    QVERIFY(hibpFile.resize(numLines * SPARSE_LINE_WIDTH));
+    QVERIFY(hibpFile.seek(0));
+    QCOMPARE(hibpFile.write(sparseLine(0)), SPARSE_LINE_WIDTH);
+    // The first and the last line are checked up front, the line before
+    // the last one ends the backwards scan for the start of the last line
+    for (qint64 index = numLines - 2; index < numLines; ++index) {
+        QVERIFY(hibpFile.seek(index * SPARSE_LINE_WIDTH));
+        QCOMPARE(hibpFile.write(sparseLine(index)), SPARSE_LINE_WIDTH);
+    }
+
+    Group* root = m_db->rootGroup();
+    for (int i = 0; i < 1000; ++i) {
+        auto entry = new Entry();
+        entry->setPassword(QString("password%1").arg(i));
+        entry->setGroup(root);
+
+        const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
+        QVERIFY(materializeSearchPath(hibpFile, numLines, sha1.toHex().toUpper()));
+    }
+    QVERIFY(hibpFile.flush());
+
+    QList<QPair<const Entry*, int>> findings;
+    QString error;
+    QBENCHMARK
+    {
+        findings.clear();
+        QVERIFY(HibpOffline::report(m_db, hibpFile, findings, &error));
+    }
+    QCOMPARE(error, QString());
+}
@@ -34,6 +34,14 @@ private slots:
     void testEmpty();
     void testIoError();
     void testPwned();
+    void testPwnedSorted();
+    void testPwnedLineTerminators_data();
+    void testPwnedLineTerminators();
+    void testPwnedUnsorted();
+    void testPwnedLargeCount();
+    void testIndex();
+    void testIndexUnsorted();
+    void benchmarkSparseFile();
 
 private:
     QSharedPointer<Database> m_db;
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestHibpDownloader.h"
+
+#include "core/Config.h"
+#include "core/HibpDownloader.h"
+
+#include <QDir>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTcpSocket>
+#include <QTest>
+#include <QTimer>
+
+QTEST_GUILESS_MAIN(TestHibpDownloader)
+
+namespace
+{
+    // Range responses of the stand-in, SHA1("password") starts with 5BAA6,
+    // SHA1("password136") and SHA1("password1818") both start with BD30B
+    const QHash<QString, QByteArray> Ranges = {
+        {"5BAA6",
+         "003D68EB55068C33ACE09247EE4C639306B:3\r\n"
+         "1E4C9B93F3F0682250B6CF8331B7EE68FD8:3861493\r\n"
+         "012C192B2F16F82EA0EB9EF18D9D539B0DD:1\r\n"},
+        {"BD30B",
+         "559BD9A84C988F99A2B3B05F4980E6D06CD:5\r\n"
+         "4E206823991DE29A0C764E7F6CA6D98A891:2\r\n"},
+    };
+} // namespace
+
+void TestHibpDownloader::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    Config::createTempFileInstance();
+
+    // Answer every request after a short delay, to have several requests open at once
+    connect(&m_server, &QTcpServer::newConnection, this, [this] {
+        auto socket = m_server.nextPendingConnection();
+        connect(socket, &QTcpSocket::readyRead, socket, [this, socket] {
+            if (!socket->canReadLine() || socket->property("path").isValid()) {
+                return;
+            }
+            const auto path = QString::fromLatin1(socket->readLine().split(' ').value(1));
+            socket->setProperty("path", path);
+            m_requests << path;
+            m_maxOpenRequests = qMax(m_maxOpenRequests, ++m_openRequests);
+
+            auto timer = new QTimer(socket);
+            timer->setSingleShot(true);
+            connect(timer, &QTimer::timeout, socket, [this, socket, path] {
+                --m_openRequests;
+                QByteArray status = "200 OK";
+                QByteArray body;
+                if (path.startsWith("/range/")) {
+                    body = Ranges.value(path.mid(7), "0000000000000000000000000000000000A:7\r\n");
+                } else {
+                    status = "500 Internal Server Error";
+                }
+                socket->write("HTTP/1.1 " + status + "\r\nContent-Length: " + QByteArray::number(body.size())
+                              + "\r\nConnection: close\r\n\r\n" + body);
+                socket->disconnectFromHost();
+            });
+            timer->start(20);
+        });
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+    });
+    QVERIFY(m_server.listen(QHostAddress::LocalHost));
+}
+
+void TestHibpDownloader::init()
+{
+    config()->resetToDefaults();
+    config()->set(Config::HibpRangeUrl, QString("http://127.0.0.1:%1/range/").arg(m_server.serverPort()));
+    QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/hibp").removeRecursively();
+
+    m_requests.clear();
+    m_maxOpenRequests = 0;
+}
+
+QHash<QString, int> TestHibpDownloader::validate(HibpDownloader& downloader, const QStringList& passwords)
+{
+    QHash<QString, int> results;
+    connect(&downloader, &HibpDownloader::hibpResult, this, [&](const QString& password, int count) {
+        results.insert(password, count);
+    });
+
+    for (const auto& password : passwords) {
+        downloader.add(password);
+    }
+    downloader.validate();
+    for (int i = 0; i < 100 && downloader.passwordsRemaining() > 0; ++i) {
+        QTest::qWait(50);
+    }
+
+    disconnect(&downloader, &HibpDownloader::hibpResult, this, nullptr);
+    return results;
+}
+
+void TestHibpDownloader::testDeduplicatedQueries()
+{
+    config()->set(Config::HibpMaxConcurrentRequests, 2);
+
+    QStringList passwords = {"password", "password136", "password1818", "another password"};
+    for (int i = 0; i < 6; ++i) {
+        passwords << QString("password%1").arg(i);
+    }
+
+    HibpDownloader downloader;
+    const auto results = validate(downloader, passwords);
+    QCOMPARE(downloader.passwordsRemaining(), 0);
+    QCOMPARE(results.size(), passwords.size());
+    QCOMPARE(results.value("password"), 3861493);
+    QCOMPARE(results.value("password136"), 5);
+    QCOMPARE(results.value("password1818"), 0);
+    QCOMPARE(results.value("another password"), 0);
+
+    // One query per prefix, at most two at once
+    QCOMPARE(m_requests.size(), passwords.size() - 1);
+    QCOMPARE(m_requests.toSet().size(), m_requests.size());
+    QVERIFY(m_requests.contains("/range/BD30B"));
+    QCOMPARE(m_maxOpenRequests, 2);
+}
+
+void TestHibpDownloader::testCachedRanges()
+{
+    const QStringList passwords = {"password", "password136"};
+
+    HibpDownloader downloader;
+    QCOMPARE(validate(downloader, passwords).size(), 2);
+    QCOMPARE(m_requests.size(), 2);
+
+    // Cached ranges are used by later runs
+    HibpDownloader cachedDownloader;
+    const auto results = validate(cachedDownloader, passwords);
+    QCOMPARE(results.value("password"), 3861493);
+    QCOMPARE(results.value("password136"), 5);
+    QCOMPARE(m_requests.size(), 2);
+
+    // Expired ranges are queried again
+    config()->set(Config::HibpCacheTtl, 0);
+    HibpDownloader uncachedDownloader;
+    QCOMPARE(validate(uncachedDownloader, passwords).size(), 2);
+    QCOMPARE(m_requests.size(), 4);
+}
+
+void TestHibpDownloader::testFetchFailed()
+{
+    config()->set(Config::HibpRangeUrl, QString("http://127.0.0.1:%1/unavailable/").arg(m_server.serverPort()));
+
+    HibpDownloader downloader;
+    QSignalSpy spyFailed(&downloader, SIGNAL(fetchFailed(QString)));
+    const auto results = validate(downloader, {"password", "password136", "another password"});
+
+    QVERIFY(results.isEmpty());
+    QCOMPARE(spyFailed.count(), 1);
+    QCOMPARE(downloader.passwordsRemaining(), 0);
+}
@@ -523,6 +523,79 @@ void TestKeePass2Format::testKdbxProtectedAttributes()
     QCOMPARE(entry->attributes()->isProtected("test"), true);
 }
 
+void TestKeePass2Format::testKdbxLazyProtectedAttributes()
+{
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("test"));
+    QSharedPointer<Database> db(new Database());
+    db->changeKdf(fastKdf(KeePass2::uuidToKdf(m_kdbxSourceDb->kdf()->uuid())));
+    db->setKey(key);
+
+    auto entry = new Entry();
+    entry->setGroup(db->rootGroup());
+    entry->setTitle("Title");
+    entry->setPassword("Old password \xe2\x82\xac");
+    entry->beginUpdate();
+    entry->setPassword("New password");
+    entry->attributes()->set("secret", "Protected value", true);
+    entry->endUpdate();
+    QCOMPARE(entry->historyItems().size(), 1);
+    const int historySize = entry->historyItems().at(0)->size();
+
+    bool hasError;
+    QString errorString;
+    QBuffer buffer;
+    buffer.open(QBuffer::ReadWrite);
+
+    // Write the database twice, the second time without accessing any protected value
+    for (int i = 0; i < 2; ++i) {
+        buffer.seek(0);
+        writeKdbx(&buffer, db.data(), hasError, errorString);
+        QVERIFY2(!hasError, qPrintable(errorString));
+
+        db = QSharedPointer<Database>::create();
+        buffer.seek(0);
+        readKdbx(&buffer, key, db, hasError, errorString);
+        QVERIFY2(!hasError, qPrintable(errorString));
+    }
+
+    QCOMPARE(db->rootGroup()->entries().size(), 1);
+    entry = db->rootGroup()->entries().at(0);
+    auto historyItem = entry->historyItems().at(0);
+    QCOMPARE(historyItem->size(), historySize);
+    QVERIFY(historyItem->attributes()->isProtected(EntryAttributes::PasswordKey));
+    QCOMPARE(historyItem->password(), QString::fromUtf8("Old password \xe2\x82\xac"));
+
+    // Copies share protected values until they change
+    QScopedPointer<Entry> clone(entry->clone(Entry::CloneNoFlags));
+    QVERIFY(*clone->attributes() == *entry->attributes());
+    QCOMPARE(clone->attributes()->value("secret"), QString("Protected value"));
+    QCOMPARE(entry->password(), QString("New password"));
+    QVERIFY(entry->attributes()->isProtected("secret"));
+    QVERIFY(entry->attributes()->containsValue("Protected value"));
+
+    entry->setPassword("Changed password");
+    QVERIFY(*clone->attributes() != *entry->attributes());
+    QCOMPARE(entry->password(), QString("Changed password"));
+    QCOMPARE(clone->password(), QString("New password"));
+
+    // A value that can't be decrypted stays encrypted and makes saving fail
+    auto broken = QSharedPointer<const EntryAttributes::LazyValue>::create(
+        QByteArray("ciphertext"), 0, QSharedPointer<const KeePass2RandomStream>());
+    entry->attributes()->setLazy("broken", broken);
+    bool ok;
+    QVERIFY(entry->attributes()->value("broken", &ok).isEmpty());
+    QVERIFY(!ok);
+    QVERIFY(entry->attributes()->valueUtf8("broken", &ok).isEmpty());
+    QVERIFY(!ok);
+    QCOMPARE(broken->size(), 10);
+
+    buffer.seek(0);
+    writeKdbx(&buffer, db.data(), hasError, errorString);
+    QVERIFY(hasError);
+    QVERIFY(errorString.contains("broken"));
+}
+
 void TestKeePass2Format::testKdbxAttachments()
 {
     Entry* entry = m_kdbxTargetDb->rootGroup()->entries().at(0);
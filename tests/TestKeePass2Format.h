@@ -56,6 +56,7 @@ private slots:
     void testReadBackTargetDb();
     void testKdbxBasic();
     void testKdbxProtectedAttributes();
+    void testKdbxLazyProtectedAttributes();
     void testKdbxAttachments();
     void testKdbxNonAsciiPasswords();
     void testKdbxDeviceFailure();
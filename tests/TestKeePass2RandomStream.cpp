@@ -87,3 +87,42 @@ void TestKeePass2RandomStream::test()
     QCOMPARE(cipherData, cipherDataEncrypt);
     QCOMPARE(randomStreamData, cipherData);
 }
+
+void TestKeePass2RandomStream::testSkip()
+{
+    const QByteArray key("\x11\x22\x33\x44\x55\x66\x77\x88");
+    const QByteArray data(QByteArray::fromHex("601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5"
+                                              "2b0930daa23de94ce87017ba2d84988ddfc9c58db67aada613c2dd08457941a6"
+                                              "1abc932417521ca24f2b0459fe7e6e0b090339ec0aa6faefd5ccc2c6f4ce8e94"));
+
+    for (auto mode : {SymmetricCipher::Salsa20, SymmetricCipher::ChaCha20}) {
+        KeePass2RandomStream sequentialStream;
+        QVERIFY(sequentialStream.init(mode, key));
+        bool ok;
+        const QByteArray expected = sequentialStream.process(data, &ok);
+        QVERIFY(ok);
+        QCOMPARE(sequentialStream.position(), quint64(data.size()));
+
+        // Skipped parts can be processed later on, in any order
+        KeePass2RandomStream randomStream;
+        QVERIFY(randomStream.init(mode, key));
+        QVERIFY(randomStream.skip(5));
+        QByteArray middle = data.mid(5, 70);
+        QVERIFY(randomStream.processInPlace(middle));
+        QCOMPARE(middle, expected.mid(5, 70));
+        QVERIFY(randomStream.skip(1));
+        QCOMPARE(randomStream.position(), quint64(76));
+        QCOMPARE(randomStream.process(data.mid(76), &ok), expected.mid(76));
+        QVERIFY(ok);
+
+        auto clonedStream = randomStream.clone();
+        QVERIFY(clonedStream);
+        QByteArray skipped = data.mid(75, 1);
+        QVERIFY(clonedStream->processAt(skipped, 75));
+        QCOMPARE(skipped, expected.mid(75, 1));
+        skipped = data.left(5);
+        QVERIFY(randomStream.processAt(skipped, 0));
+        QCOMPARE(skipped, expected.left(5));
+        QCOMPARE(randomStream.position(), quint64(data.size()));
+    }
+}
@@ -1384,6 +1384,92 @@ void TestMerge::testDeletedRevertedGroup()
     QVERIFY(group2DestinationMerged->notes() == "Updated");
 }
 
+/**
+ * Entries with the same modification time still pick up history
+ * items that only exist in the source.
+ */
+void TestMerge::testMergeHistoryOnlyInSource()
+{
+    QScopedPointer<Database> dbDestination(createTestDatabase());
+    QScopedPointer<Database> dbSource(createTestDatabaseStructureClone(
+        dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+
+    Entry* sourceEntry = dbSource->rootGroup()->findEntryByPath("/group1/entry1");
+    Entry* destinationEntry = dbDestination->rootGroup()->findEntryByPath("/group1/entry1");
+    QVERIFY(sourceEntry);
+    QVERIFY(destinationEntry);
+    const int historyCount = destinationEntry->historyItems().count();
+    QCOMPARE(sourceEntry->historyItems().count(), historyCount);
+
+    auto historyItem = sourceEntry->clone(Entry::CloneNoFlags);
+    TimeInfo timeInfo = historyItem->timeInfo();
+    timeInfo.setLastModificationTime(timeInfo.lastModificationTime().addDays(-10));
+    historyItem->setTimeInfo(timeInfo);
+    sourceEntry->setUpdateTimeinfo(false);
+    sourceEntry->addHistoryItem(historyItem);
+    QCOMPARE(sourceEntry->timeInfo().lastModificationTime(), destinationEntry->timeInfo().lastModificationTime());
+
+    m_clock->advanceSecond(1);
+
+    Merger merger(dbSource.data(), dbDestination.data());
+    const auto changes = merger.merge();
+
+    QCOMPARE(changes,
+             QStringList() << QString("Synchronizing from older source entry1 [%1]").arg(destinationEntry->uuidToHex()));
+    QCOMPARE(destinationEntry->historyItems().count(), historyCount + 1);
+
+    // Merging again finds nothing left to do
+    Merger merger2(dbSource.data(), dbDestination.data());
+    QVERIFY(merger2.merge().isEmpty());
+}
+
+void TestMerge::benchmarkMerge()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QScopedPointer<Database> dbDestination(new Database());
+    for (int i = 0; i < 100; ++i) {
+        auto group = new Group();
+        group->setUuid(QUuid::createUuid());
+        group->setName(QString("group%1").arg(i));
+        group->setParent(dbDestination->rootGroup());
+        for (int j = 0; j < 200; ++j) {
+            auto entry = new Entry();
+            entry->setUuid(QUuid::createUuid());
+            entry->setGroup(group);
+            for (int k = 0; k < 3; ++k) {
+                m_clock->advanceSecond(1);
+                entry->beginUpdate();
+                entry->setTitle(QString("entry%1-%2 rev%3").arg(i).arg(j).arg(k));
+                entry->endUpdate();
+            }
+        }
+    }
+
+    QScopedPointer<Database> dbSource(createTestDatabaseStructureClone(
+        dbDestination.data(), Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+
+    // Update every tenth entry in the source
+    m_clock->advanceMinute(1);
+    const auto sourceEntries = dbSource->rootGroup()->entriesRecursive();
+    for (int i = 0; i < sourceEntries.size(); i += 10) {
+        sourceEntries[i]->beginUpdate();
+        sourceEntries[i]->setPassword("updated");
+        sourceEntries[i]->endUpdate();
+    }
+
+    QStringList changes;
+    QBENCHMARK_ONCE
+    {
+        Merger merger(dbSource.data(), dbDestination.data());
+        changes = merger.merge();
+    }
+    QCOMPARE(changes.size(), sourceEntries.size() / 10);
+}
+
 /**
  * If the group is updated in the source database, and the
  * destination database after, the group should remain the
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TestNativeMessagingProxy.h"
+
+#include "browser/BrowserShared.h"
+
+#include <QLocalSocket>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(TestNativeMessagingProxy)
+
+namespace
+{
+    const int TIMEOUT = 5000;
+
+    // Native messaging frames each message with its length in native byte order
+    QByteArray frame(const QByteArray& msg)
+    {
+        const quint32 length = msg.size();
+        return QByteArray(reinterpret_cast<const char*>(&length), sizeof(length)) + msg;
+    }
+} // namespace
+
+void TestNativeMessagingProxy::initTestCase()
+{
+    QVERIFY(m_runtimeDir.isValid());
+#if defined(Q_OS_UNIX) && !defined(Q_OS_MACOS)
+    // Don't interfere with a running KeePassXC instance
+    qputenv("XDG_RUNTIME_DIR", m_runtimeDir.path().toLocal8Bit());
+#endif
+}
+
+void TestNativeMessagingProxy::init()
+{
+    const auto serverPath = BrowserShared::localServerPath();
+    QLocalServer::removeServer(serverPath);
+    m_server.reset(new QLocalServer());
+    QVERIFY(m_server->listen(serverPath));
+
+    m_proxy.reset(new QProcess());
+    m_proxy->start(KEEPASSXC_PROXY_PATH, QStringList());
+    QVERIFY(m_proxy->waitForStarted(TIMEOUT));
+
+    QVERIFY(m_server->waitForNewConnection(TIMEOUT));
+    m_socket = m_server->nextPendingConnection();
+    QVERIFY(m_socket);
+}
+
+void TestNativeMessagingProxy::cleanup()
+{
+    // The proxy quits when the browser closes its standard input
+    m_proxy->closeWriteChannel();
+    QVERIFY(m_proxy->waitForFinished(TIMEOUT));
+    QCOMPARE(m_proxy->exitCode(), 0);
+
+    m_socket = nullptr;
+    m_proxy.reset();
+    m_server.reset();
+}
+
+void TestNativeMessagingProxy::sendToProxy(const QByteArray& msg)
+{
+    m_proxy->write(frame(msg));
+    QVERIFY(m_proxy->waitForBytesWritten(TIMEOUT));
+}
+
+QByteArray TestNativeMessagingProxy::receiveFromProxy(int size)
+{
+    QByteArray received;
+    while (received.size() < size) {
+        if (m_socket->bytesAvailable() == 0 && !m_socket->waitForReadyRead(TIMEOUT)) {
+            break;
+        }
+        received.append(m_socket->readAll());
+    }
+    return received;
+}
+
+void TestNativeMessagingProxy::roundTrip(const QByteArray& request, const QByteArray& response)
+{
+    sendToProxy(request);
+    QCOMPARE(receiveFromProxy(request.size()), request);
+
+    m_socket->write(response);
+    QVERIFY(m_socket->waitForBytesWritten(TIMEOUT));
+
+    const auto expected = frame(response);
+    QByteArray output;
+    while (output.size() < expected.size()) {
+        if (m_proxy->bytesAvailable() == 0 && !m_proxy->waitForReadyRead(TIMEOUT)) {
+            break;
+        }
+        output.append(m_proxy->readAllStandardOutput());
+    }
+    QCOMPARE(output, expected);
+}
+
+void TestNativeMessagingProxy::testRoundTrip()
+{
+    roundTrip(R"({"action":"get-databasehash"})", R"({"action":"get-databasehash","hash":"29234e32"})");
+}
+
+void TestNativeMessagingProxy::testNonAsciiMessage()
+{
+    // Multi-byte UTF-8 must be forwarded unchanged and in full
+    const QByteArray request = "{\"action\":\"get-logins\",\"url\":\"https://\xd0\xbf\xd1\x80\xd0\xb8\xd0\xbc\xd0\xb5\xd1"
+                               "\x80.example\"}";
+    const QByteArray response = "{\"login\":\"\xe7\xa7\x98\xe5\xaf\x86\xf0\x9f\x94\x91\"}";
+    roundTrip(request, response);
+}
+
+void TestNativeMessagingProxy::testConsecutiveMessages()
+{
+    const QByteArray first = R"({"action":"change-public-keys"})";
+    const QByteArray second = R"({"action":"associate"})";
+
+    // Both messages are forwarded without waiting for a reply in between
+    m_proxy->write(frame(first) + frame(second));
+    QVERIFY(m_proxy->waitForBytesWritten(TIMEOUT));
+    QCOMPARE(receiveFromProxy(first.size() + second.size()), first + second);
+}
+
+void TestNativeMessagingProxy::testLargeMessage()
+{
+    QByteArray request(BrowserShared::NATIVEMSG_MAX_LENGTH / 2, 'a');
+    request.prepend(R"({"payload":")").append(R"("})");
+    sendToProxy(request);
+    QCOMPARE(receiveFromProxy(request.size()), request);
+}
+
+void TestNativeMessagingProxy::benchmarkRoundTrip()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    const QByteArray request = R"({"action":"get-logins","url":"https://example.com"})";
+    const QByteArray response = R"({"action":"get-logins","count":1,"entries":[]})";
+    QBENCHMARK {
+        roundTrip(request, response);
+    }
+}
@@ -0,0 +1,50 @@
+/*
+ *  Copyright (C) 2024 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
+#define KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
+
+#include <QLocalServer>
+#include <QProcess>
+#include <QTemporaryDir>
+
+class TestNativeMessagingProxy : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void testRoundTrip();
+    void testNonAsciiMessage();
+    void testConsecutiveMessages();
+    void testLargeMessage();
+    void benchmarkRoundTrip();
+
+private:
+    void sendToProxy(const QByteArray& msg);
+    QByteArray receiveFromProxy(int size);
+    void roundTrip(const QByteArray& request, const QByteArray& response);
+
+    QTemporaryDir m_runtimeDir;
+    QScopedPointer<QLocalServer> m_server;
+    QScopedPointer<QProcess> m_proxy;
+    QLocalSocket* m_socket = nullptr;
+};
+
+#endif // KEEPASSXC_TESTNATIVEMESSAGINGPROXY_H
@@ -52,3 +52,18 @@ void TestPassphraseGenerator::testWordCase()
     QRegularExpression regex("^(?:[A-Z][a-z-]* )*[A-Z][a-z-]*$");
     QVERIFY2(regex.match(passphrase).hasMatch(), qPrintable(passphrase));
 }
+
+void TestPassphraseGenerator::testGeneratePassphrases()
+{
+    PassphraseGenerator generator;
+    generator.setWordSeparator(" ");
+    generator.setWordCount(4);
+    QVERIFY(generator.isValid());
+
+    const auto passphrases = generator.generatePassphrases(100);
+    QCOMPARE(passphrases.size(), 100);
+    for (const auto& passphrase : passphrases) {
+        QCOMPARE(passphrase.split(" ").size(), 4);
+    }
+    QCOMPARE(passphrases.toSet().size(), 100);
+}
@@ -18,6 +18,7 @@
 #include "TestPasswordGenerator.h"
 #include "crypto/Crypto.h"
 
+#include <QHash>
 #include <QRegularExpression>
 #include <QTest>
 
@@ -281,3 +282,66 @@ void TestPasswordGenerator::testReset()
     QCOMPARE(m_generator.getExcludedCharacterSet(), default_generator.getExcludedCharacterSet());
     QCOMPARE(m_generator.getLength(), default_generator.getLength());
 }
+
+void TestPasswordGenerator::testGeneratePasswords()
+{
+    m_generator.setLength(16);
+    m_generator.setCharClasses(PasswordGenerator::CharClass::LowerLetters | PasswordGenerator::CharClass::Numbers);
+    m_generator.setFlags(PasswordGenerator::GeneratorFlag::CharFromEveryGroup);
+    QVERIFY(m_generator.isValid());
+
+    const auto passwords = m_generator.generatePasswords(1000);
+    QCOMPARE(passwords.size(), 1000);
+
+    QRegularExpression regex("^(?=.*[a-z])(?=.*[0-9])[a-z0-9]{16}$");
+    for (const auto& password : passwords) {
+        QVERIFY2(regex.match(password).hasMatch(), qPrintable(password));
+    }
+    QCOMPARE(passwords.toSet().size(), passwords.size());
+
+    QVERIFY(m_generator.generatePasswords(0).isEmpty());
+}
+
+void TestPasswordGenerator::testUniformity()
+{
+    m_generator.setLength(100);
+    m_generator.setCharClasses(PasswordGenerator::CharClass::LowerLetters);
+    m_generator.setFlags(PasswordGenerator::GeneratorFlag::NoFlags);
+
+    // Chi-squared test of the character frequencies
+    QHash<QChar, int> counts;
+    const auto passwords = m_generator.generatePasswords(1000);
+    for (const auto& password : passwords) {
+        for (const auto& ch : password) {
+            ++counts[ch];
+        }
+    }
+    QCOMPARE(counts.size(), 26);
+
+    const double expected = 100.0 * 1000 / 26;
+    double chiSquared = 0;
+    for (int count : counts) {
+        chiSquared += (count - expected) * (count - expected) / expected;
+    }
+
+    // Critical value for 25 degrees of freedom at p = 0.0001
+    QVERIFY2(chiSquared < 59.97, qPrintable(QString::number(chiSquared)));
+}
+
+void TestPasswordGenerator::benchmarkGeneratePasswords()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    m_generator.setLength(32);
+    m_generator.setCharClasses(PasswordGenerator::CharClass::DefaultCharset
+                               | PasswordGenerator::CharClass::SpecialCharacters);
+
+    QBENCHMARK
+    {
+        QCOMPARE(m_generator.generatePasswords(10000).size(), 10000);
+    }
+}
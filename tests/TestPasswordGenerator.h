@@ -43,6 +43,9 @@ private slots:
     void testValidity_data();
     void testValidity();
     void testReset();
+    void testGeneratePasswords();
+    void testUniformity();
+    void benchmarkGeneratePasswords();
 };
 
 #endif // KEEPASSXC_TESTPASSWORDGENERATOR_H
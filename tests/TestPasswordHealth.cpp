@@ -17,7 +17,9 @@
 
 #include "TestPasswordHealth.h"
 
+#include "core/Group.h"
 #include "core/PasswordHealth.h"
+#include "crypto/Crypto.h"
 
 #include <QTest>
 
@@ -25,6 +27,7 @@ QTEST_GUILESS_MAIN(TestPasswordHealth)
 
 void TestPasswordHealth::initTestCase()
 {
+    QVERIFY(Crypto::init());
 }
 
 void TestPasswordHealth::testNoDb()
@@ -64,3 +67,65 @@ void TestPasswordHealth::testNoDb()
     QVERIFY(excellent.scoreReason().isEmpty());
     QVERIFY(excellent.scoreDetails().isEmpty());
 }
+
+void TestPasswordHealth::testEngine()
+{
+    auto db = QSharedPointer<Database>::create();
+    QList<Entry*> entries;
+    for (const auto& pwd : {"secret", "Yohb2ChR4", "secret", "MIhIN9UKrgtPL2hp"}) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(pwd);
+        entry->setPassword(pwd);
+        entry->setGroup(db->rootGroup());
+        entries << entry;
+    }
+
+    // Parallel evaluation gives the same result as the health checker
+    HealthChecker checker(db);
+    PasswordHealthEngine engine;
+    const auto results = engine.evaluate(db, entries);
+    QCOMPARE(results.size(), entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        const auto expected = checker.evaluate(entries[i]);
+        QCOMPARE(results[i]->score(), expected->score());
+        QCOMPARE(results[i]->scoreReason(), expected->scoreReason());
+        QCOMPARE(results[i]->scoreDetails(), expected->scoreDetails());
+    }
+    QVERIFY(results[0]->scoreReason().contains("used 2 time"));
+    QCOMPARE(results[0]->score(), results[2]->score());
+
+    // Background evaluation reports every entry once, then finishes
+    PasswordHealthEngine background;
+    QHash<Entry*, int> scores;
+    int finished = 0;
+    connect(&background, &PasswordHealthEngine::entryEvaluated, [&](Entry* entry, QSharedPointer<PasswordHealth> health) {
+        QVERIFY(!scores.contains(entry));
+        scores.insert(entry, health->score());
+    });
+    connect(&background, &PasswordHealthEngine::finished, [&] { ++finished; });
+
+    background.start(db, entries);
+    QTRY_COMPARE(finished, 1);
+    QVERIFY(!background.isRunning());
+    QCOMPARE(scores.size(), entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        QCOMPARE(scores.value(entries[i]), results[i]->score());
+    }
+
+    // Known passwords are reported right away
+    scores.clear();
+    background.start(db, entries);
+    QCOMPARE(finished, 2);
+    QCOMPARE(scores.size(), entries.size());
+
+    // A cancelled evaluation doesn't report anything afterwards
+    scores.clear();
+    entries[3]->setPassword("prompter-ream-oversleep-step-extortion-quarrel-reflected-prefix");
+    background.start(db, entries);
+    background.cancel();
+    QVERIFY(!background.isRunning());
+    QTest::qWait(100);
+    QCOMPARE(finished, 2);
+    QVERIFY(!scores.contains(entries[3]));
+}
@@ -20,10 +20,19 @@
 #include "core/Global.h"
 #include "crypto/Random.h"
 
+#include <QSet>
 #include <QTest>
 
+#ifdef Q_OS_UNIX
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 QTEST_GUILESS_MAIN(TestRandomGenerator)
 
+Q_DECLARE_METATYPE(Random::Mode)
+
 void TestRandomGenerator::testArray()
 {
     auto ba = randomGen()->randomArray(10);
@@ -58,3 +67,116 @@ void TestRandomGenerator::testUIntRange()
         QVERIFY(rand < 200);
     }
 }
+
+void TestRandomGenerator::testBufferedUInt()
+{
+    auto random = randomGen(Random::BufferedDrbg);
+    QVERIFY(random != randomGen());
+    QVERIFY(random == randomGen(Random::BufferedDrbg));
+
+    QVERIFY(random->randomUInt(0) == 0);
+    QVERIFY(random->randomUInt(1) == 0);
+
+    // Draw more numbers than fit into the buffer at once
+    QSet<quint32> numbers;
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(random->randomUInt(5) < 5);
+        QVERIFY(random->randomUIntRange(100, 200) >= 100);
+        numbers.insert(random->randomUInt(QUINT32_MAX));
+    }
+    // Collisions are possible but should be rare
+    QVERIFY(numbers.size() > 990);
+}
+
+void TestRandomGenerator::testBufferedUIntAfterFork()
+{
+#ifdef Q_OS_UNIX
+    auto random = randomGen(Random::BufferedDrbg);
+    // Make sure the buffer is filled before forking
+    random->randomUInt(QUINT32_MAX);
+
+    int fds[2];
+    QCOMPARE(pipe(fds), 0);
+    const pid_t pid = fork();
+    QVERIFY(pid >= 0);
+    if (pid == 0) {
+        quint32 numbers[4];
+        for (auto& number : numbers) {
+            number = random->randomUInt(QUINT32_MAX);
+        }
+        const bool written = write(fds[1], numbers, sizeof(numbers)) == static_cast<ssize_t>(sizeof(numbers));
+        _exit(written ? 0 : 1);
+    }
+
+    close(fds[1]);
+    quint32 childNumbers[4];
+    const auto size = read(fds[0], childNumbers, sizeof(childNumbers));
+    close(fds[0]);
+    int status = 0;
+    QCOMPARE(waitpid(pid, &status, 0), pid);
+    QVERIFY(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    QCOMPARE(size, static_cast<ssize_t>(sizeof(childNumbers)));
+
+    // The child must not hand out the numbers left in the buffer of the parent
+    quint32 numbers[4];
+    for (auto& number : numbers) {
+        number = random->randomUInt(QUINT32_MAX);
+    }
+    QVERIFY(std::memcmp(numbers, childNumbers, sizeof(numbers)) != 0);
+#else
+    QSKIP("fork() is not available on this platform");
+#endif
+}
+
+void TestRandomGenerator::testUniformity_data()
+{
+    QTest::addColumn<Random::Mode>("mode");
+    QTest::newRow("System RNG") << Random::SystemRng;
+    QTest::newRow("Buffered DRBG") << Random::BufferedDrbg;
+}
+
+void TestRandomGenerator::testUniformity()
+{
+    QFETCH(Random::Mode, mode);
+
+    // Chi-squared test of a limit that does not divide 2^32, to catch modulo bias as well
+    const quint32 Buckets = 10;
+    const int Samples = 100000;
+    QVector<int> counts(Buckets, 0);
+    for (int i = 0; i < Samples; ++i) {
+        ++counts[randomGen(mode)->randomUInt(Buckets)];
+    }
+
+    const double expected = static_cast<double>(Samples) / Buckets;
+    double chiSquared = 0;
+    for (int count : counts) {
+        chiSquared += (count - expected) * (count - expected) / expected;
+    }
+
+    // Critical value for 9 degrees of freedom at p = 0.0001
+    QVERIFY2(chiSquared < 33.72, qPrintable(QString::number(chiSquared)));
+}
+
+void TestRandomGenerator::benchmarkUInt_data()
+{
+    testUniformity_data();
+}
+
+void TestRandomGenerator::benchmarkUInt()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(Random::Mode, mode);
+    auto random = randomGen(mode);
+
+    QBENCHMARK
+    {
+        for (int i = 0; i < 100000; ++i) {
+            random->randomUInt(94);
+        }
+    }
+}
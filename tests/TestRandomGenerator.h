@@ -28,6 +28,12 @@ private slots:
     void testArray();
     void testUInt();
     void testUIntRange();
+    void testBufferedUInt();
+    void testBufferedUIntAfterFork();
+    void testUniformity_data();
+    void testUniformity();
+    void benchmarkUInt_data();
+    void benchmarkUInt();
 };
 
 #endif // KEEPASSX_TESTRANDOMGENERATOR_H
@@ -18,6 +18,8 @@
 #include "TestSSHAgent.h"
 #include "config-keepassx-tests.h"
 #include "core/Config.h"
+#include "core/Database.h"
+#include "core/Group.h"
 #include "crypto/Crypto.h"
 #include "sshagent/KeeAgentSettings.h"
 #include "sshagent/OpenSSHKeyGen.h"
@@ -285,6 +287,61 @@ void TestSSHAgent::testKeyGenEd25519()
     QVERIFY(agent.checkIdentity(key, keyInAgent) && !keyInAgent);
 }
 
+void TestSSHAgent::testDatabaseUnlock()
+{
+    SSHAgent agent;
+    agent.setEnabled(true);
+    agent.setAuthSockOverride(m_agentSocketFileName);
+
+    QVERIFY(agent.isAgentRunning());
+
+    auto db = QSharedPointer<Database>::create();
+    KeeAgentSettings settings;
+    settings.setAllowUseOfSshKey(true);
+    settings.setAddAtDatabaseOpen(true);
+    settings.setRemoveAtDatabaseClose(true);
+
+    // Several attachment keys and an encrypted key file are loaded together
+    QList<OpenSSHKey> keys;
+    for (int i = 0; i < 8; ++i) {
+        OpenSSHKey key;
+        QVERIFY(OpenSSHKeyGen::generateEd25519(key));
+
+        auto entry = new Entry();
+        entry->setGroup(db->rootGroup());
+        entry->setUsername(QString("user%1").arg(i));
+        entry->attachments()->set("id_ed25519", key.privateKey().toLatin1());
+        settings.setSelectedType("attachment");
+        settings.setAttachmentName("id_ed25519");
+        settings.toEntry(entry);
+
+        keys.append(key);
+    }
+
+    auto entry = new Entry();
+    entry->setGroup(db->rootGroup());
+    entry->setPassword("correctpassphrase");
+    settings.setSelectedType("file");
+    settings.setFileName(QString("%1/id_rsa-encrypted-asn1").arg(QString(KEEPASSX_TEST_DATA_DIR)));
+    settings.toEntry(entry);
+
+    OpenSSHKey fileKey;
+    QVERIFY(settings.toOpenSSHKey(entry, fileKey, true));
+    keys.append(fileKey);
+
+    agent.databaseUnlocked(db);
+
+    bool keyInAgent;
+    for (const auto& key : keys) {
+        QTRY_VERIFY(agent.checkIdentity(key, keyInAgent) && keyInAgent);
+    }
+
+    agent.databaseLocked(db);
+    for (const auto& key : keys) {
+        QVERIFY(agent.checkIdentity(key, keyInAgent) && !keyInAgent);
+    }
+}
+
 void TestSSHAgent::cleanupTestCase()
 {
     if (m_agentProcess.state() != QProcess::NotRunning) {
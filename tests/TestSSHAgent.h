@@ -38,6 +38,7 @@ private slots:
     void testKeyGenRSA();
     void testKeyGenECDSA();
     void testKeyGenEd25519();
+    void testDatabaseUnlock();
     void cleanupTestCase();
 
 private:
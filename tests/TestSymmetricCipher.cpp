@@ -23,6 +23,7 @@
 #include <QVector>
 
 #include "crypto/Crypto.h"
+#include "crypto/Random.h"
 #include "format/KeePass2.h"
 #include "streams/SymmetricCipherStream.h"
 
@@ -455,3 +456,126 @@ void TestSymmetricCipher::testStreamReset()
     writer.close();
     QCOMPARE(buffer.buffer().size(), 16);
 }
+
+void TestSymmetricCipher::testStreamRoundTrip_data()
+{
+    QTest::addColumn<SymmetricCipher::Mode>("mode");
+    QTest::addColumn<int>("bufferSize");
+    QTest::addColumn<int>("dataSize");
+
+    const QList<QPair<QString, SymmetricCipher::Mode>> modes = {{"AES256-CBC", SymmetricCipher::Aes256_CBC},
+                                                                {"AES256-CTR", SymmetricCipher::Aes256_CTR},
+                                                                {"ChaCha20", SymmetricCipher::ChaCha20},
+                                                                {"Twofish-CBC", SymmetricCipher::Twofish_CBC}};
+    // Sizes around the block and buffer boundaries
+    const QList<int> sizes = {1, 15, 16, 17, 4095, 4096, 4097, 8192, 100000};
+
+    for (const auto& mode : modes) {
+        for (int size : sizes) {
+            QTest::addRow("%s %d bytes, 4 KiB buffer", qPrintable(mode.first), size) << mode.second << 4096 << size;
+        }
+        QTest::addRow("%s 3 MiB, default buffer", qPrintable(mode.first)) << mode.second << 0 << 3 * 1024 * 1024 + 5;
+        QTest::addRow("%s 1000 bytes, minimum buffer", qPrintable(mode.first)) << mode.second << 1 << 1000;
+    }
+}
+
+void TestSymmetricCipher::testStreamRoundTrip()
+{
+    QFETCH(SymmetricCipher::Mode, mode);
+    QFETCH(int, bufferSize);
+    QFETCH(int, dataSize);
+
+    auto key = randomGen()->randomArray(SymmetricCipher::keySize(mode));
+    auto iv = randomGen()->randomArray(SymmetricCipher::defaultIvSize(mode));
+    auto plainText = randomGen()->randomArray(dataSize);
+    bool blockCipher = SymmetricCipher::blockSize(mode) > 1;
+
+    // The stream has to produce exactly what a single cipher call over all data produces
+    QByteArray expected = plainText;
+    SymmetricCipher cipher;
+    QVERIFY(cipher.init(mode, SymmetricCipher::Encrypt, key, iv));
+    QVERIFY(blockCipher ? cipher.finish(expected) : cipher.process(expected));
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    {
+        QScopedPointer<SymmetricCipherStream> writer(bufferSize > 0 ? new SymmetricCipherStream(&buffer, bufferSize)
+                                                                    : new SymmetricCipherStream(&buffer));
+        QVERIFY(writer->init(mode, SymmetricCipher::Encrypt, key, iv));
+        QVERIFY(writer->open(QIODevice::WriteOnly));
+        // Write in odd-sized pieces to exercise partially filled buffers
+        for (int pos = 0; pos < dataSize; pos += 1000) {
+            QCOMPARE(writer->write(plainText.mid(pos, 1000)), qint64(qMin(1000, dataSize - pos)));
+        }
+        writer->close();
+    }
+    buffer.close();
+    QCOMPARE(buffer.data(), expected);
+
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QScopedPointer<SymmetricCipherStream> reader(bufferSize > 0 ? new SymmetricCipherStream(&buffer, bufferSize)
+                                                                : new SymmetricCipherStream(&buffer));
+    QVERIFY(reader->init(mode, SymmetricCipher::Decrypt, key, iv));
+    QVERIFY(reader->open(QIODevice::ReadOnly));
+
+    QByteArray decrypted;
+    QByteArray chunk;
+    do {
+        chunk = reader->read(777);
+        decrypted.append(chunk);
+    } while (!chunk.isEmpty());
+
+    QCOMPARE(decrypted.size(), plainText.size());
+    QCOMPARE(decrypted, plainText);
+    QVERIFY(reader->errorString().isEmpty());
+}
+
+void TestSymmetricCipher::benchmarkStream_data()
+{
+    QTest::addColumn<SymmetricCipher::Mode>("mode");
+    QTest::addColumn<int>("bufferSize");
+
+    QTest::newRow("AES256-CBC block-sized buffer") << SymmetricCipher::Aes256_CBC << 32;
+    QTest::newRow("AES256-CBC 1 MiB buffer") << SymmetricCipher::Aes256_CBC << 1024 * 1024;
+    QTest::newRow("AES256-CTR block-sized buffer") << SymmetricCipher::Aes256_CTR << 32;
+    QTest::newRow("AES256-CTR 1 MiB buffer") << SymmetricCipher::Aes256_CTR << 1024 * 1024;
+    QTest::newRow("ChaCha20 2 KiB buffer") << SymmetricCipher::ChaCha20 << 2048;
+    QTest::newRow("ChaCha20 1 MiB buffer") << SymmetricCipher::ChaCha20 << 1024 * 1024;
+    QTest::newRow("Twofish-CBC block-sized buffer") << SymmetricCipher::Twofish_CBC << 32;
+    QTest::newRow("Twofish-CBC 1 MiB buffer") << SymmetricCipher::Twofish_CBC << 1024 * 1024;
+}
+
+void TestSymmetricCipher::benchmarkStream()
+{
+    QByteArray env = qgetenv("BENCHMARK");
+
+    if (env.isEmpty() || env == "0" || env == "no") {
+        QSKIP("Benchmark skipped. Set env variable BENCHMARK=1 to enable.");
+    }
+
+    QFETCH(SymmetricCipher::Mode, mode);
+    QFETCH(int, bufferSize);
+
+    // Encrypt and decrypt 16 MiB, divide the reported time by 32 MiB for the throughput
+    auto key = randomGen()->randomArray(SymmetricCipher::keySize(mode));
+    auto iv = randomGen()->randomArray(SymmetricCipher::defaultIvSize(mode));
+    QByteArray plainText(16 * 1024 * 1024, '\x4B');
+
+    QBENCHMARK
+    {
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        SymmetricCipherStream writer(&buffer, bufferSize);
+        QVERIFY(writer.init(mode, SymmetricCipher::Encrypt, key, iv));
+        QVERIFY(writer.open(QIODevice::WriteOnly));
+        QCOMPARE(writer.write(plainText), qint64(plainText.size()));
+        writer.close();
+        buffer.close();
+
+        buffer.open(QIODevice::ReadOnly);
+        SymmetricCipherStream reader(&buffer, bufferSize);
+        QVERIFY(reader.init(mode, SymmetricCipher::Decrypt, key, iv));
+        QVERIFY(reader.open(QIODevice::ReadOnly));
+        QCOMPARE(reader.readAll().size(), plainText.size());
+    }
+}
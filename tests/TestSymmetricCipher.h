@@ -39,6 +39,10 @@ private slots:
     void testChaCha20();
     void testPadding();
     void testStreamReset();
+    void testStreamRoundTrip_data();
+    void testStreamRoundTrip();
+    void benchmarkStream_data();
+    void benchmarkStream();
 };
 
 #endif // KEEPASSX_TESTSYMMETRICCIPHER_H
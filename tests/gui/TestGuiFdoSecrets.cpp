@@ -1687,6 +1687,61 @@ void TestGuiFdoSecrets::testNoExposeRecycleBin()
     COMPARE(unlocked, {});
 }
 
+void TestGuiFdoSecrets::testItemsCreatedOnDemand()
+{
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto collObj = m_plugin->dbus()->pathToObject<Collection>(QDBusObjectPath(coll->path()));
+    VERIFY(collObj);
+
+    // listing the items does not create any object
+    DBUS_GET(itemPaths, coll->items());
+    VERIFY(itemPaths.size() > 1);
+    COMPARE(collObj->findChildren<Item*>().size(), 0);
+
+    // calls on an item path are served without prior registration
+    auto entry = m_db->rootGroup()->findEntryByUuid(
+        QUuid::fromRfc4122(QByteArray::fromHex(itemPaths.first().path().split('/').last().toLatin1())));
+    VERIFY(entry);
+    auto item = getProxy<ItemProxy>(itemPaths.first());
+    VERIFY(item);
+    DBUS_COMPARE(item->label(), entry->title());
+    COMPARE(collObj->findChildren<Item*>().size(), 1);
+
+    // and the same object is reused afterwards
+    auto itemObj = m_plugin->dbus()->pathToObject<Item>(itemPaths.first());
+    VERIFY(itemObj);
+    COMPARE(itemObj->backend(), entry);
+    COMPARE(itemObj->objectPath(), itemPaths.first());
+    COMPARE(collObj->findChildren<Item*>().size(), 1);
+
+    // idle items are evicted, the next call on the path creates the item again
+    QPointer<Item> evicted = itemObj;
+    collObj->evictIdleItems();
+    VERIFY(evicted && evicted->backend());
+    collObj->evictIdleItems();
+    VERIFY(!evicted || !evicted->backend());
+    DBUS_COMPARE(item->label(), entry->title());
+    itemObj = m_plugin->dbus()->pathToObject<Item>(itemPaths.first());
+    VERIFY(itemObj);
+    VERIFY(itemObj != evicted);
+    COMPARE(itemObj->backend(), entry);
+
+    // paths of unknown entries do not resolve
+    QDBusObjectPath unknownPath(coll->path() + "/" + Tools::uuidToHex(QUuid::createUuid()));
+    VERIFY(!m_plugin->dbus()->pathToObject<Item>(unknownPath));
+
+    // deleting the entry removes the item again
+    QSignalSpy spyItemDeleted(coll.data(), SIGNAL(ItemDeleted(QDBusObjectPath)));
+    VERIFY(spyItemDeleted.isValid());
+    delete entry;
+    VERIFY(waitForSignal(spyItemDeleted, 1));
+    COMPARE(spyItemDeleted.takeFirst().at(0).value<QDBusObjectPath>(), itemPaths.first());
+    VERIFY(!m_plugin->dbus()->pathToObject<Item>(itemPaths.first()));
+}
+
 void TestGuiFdoSecrets::lockDatabaseInBackend()
 {
     m_tabWidget->lockDatabases();
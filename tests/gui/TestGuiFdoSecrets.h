@@ -100,6 +100,7 @@ private slots:
     void testExposeSubgroup();
     void testModifyingExposedGroup();
     void testNoExposeRecycleBin();
+    void testItemsCreatedOnDemand();
 
     void testHiddenFilename();
     void testDuplicateName();
@@ -81,4 +81,41 @@ void TestGuiPixmaps::testGroupIcons()
     QVERIFY(Icons::groupIconPixmap(group).toImage() == Icons::customIconPixmap(db.data(), iconUuid).toImage());
 }
 
+void TestGuiPixmaps::testCustomIconCache()
+{
+    QScopedPointer<Database> db(new Database());
+    auto entry = new Entry();
+    entry->setGroup(db->rootGroup());
+
+    QUuid iconUuid = QUuid::createUuid();
+    QImage icon(2, 1, QImage::Format_RGB32);
+    icon.fill(qRgb(0, 0, 50));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+    entry->setIcon(iconUuid);
+
+    // Repeated lookups return the same cached pixmap
+    auto pixmap = Icons::entryIconPixmap(entry);
+    QCOMPARE(Icons::entryIconPixmap(entry).cacheKey(), pixmap.cacheKey());
+    QCOMPARE(Icons::customIconPixmap(db.data(), iconUuid).cacheKey(), pixmap.cacheKey());
+    QVERIFY(Icons::customIconPixmap(db.data(), iconUuid, IconSize::Large).cacheKey() != pixmap.cacheKey());
+
+    // The expired badge is cached separately
+    entry->setExpires(true);
+    entry->setExpiryTime(QDateTime::currentDateTimeUtc().addDays(-1));
+    auto expiredPixmap = Icons::entryIconPixmap(entry);
+    QVERIFY(expiredPixmap.cacheKey() != pixmap.cacheKey());
+    QVERIFY(expiredPixmap.toImage() != pixmap.toImage());
+    QCOMPARE(Icons::entryIconPixmap(entry).cacheKey(), expiredPixmap.cacheKey());
+    entry->setExpires(false);
+
+    // Replacing the icon invalidates the cache
+    db->metadata()->removeCustomIcon(iconUuid);
+    QVERIFY(Icons::entryIconPixmap(entry).isNull());
+    icon.fill(qRgb(50, 0, 0));
+    db->metadata()->addCustomIcon(iconUuid, Icons::saveToBytes(icon));
+    auto newPixmap = Icons::entryIconPixmap(entry);
+    QVERIFY(newPixmap.cacheKey() != pixmap.cacheKey());
+    QVERIFY(newPixmap.toImage() != pixmap.toImage());
+}
+
 QTEST_MAIN(TestGuiPixmaps)
@@ -29,6 +29,7 @@ private slots:
     void testDatabaseIcons();
     void testEntryIcons();
     void testGroupIcons();
+    void testCustomIconCache();
 };
 
 #endif // KEEPASSX_TESTGUIPIXMAPS_H